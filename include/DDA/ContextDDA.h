@@ -49,6 +49,24 @@ public:
     /// Handle out-of-budget dpm
     void handleOutOfBudgetDpm(const CxtLocDPItem& dpm);
 
+    /// Batched queries. Results from previous runs are context-insensitive,
+    /// and seeded for the empty context.
+    //@{
+    virtual inline void orderDDAQueries(NodeVector& queries) {
+        sortQueriesInTopoOrder(queries);
+    }
+    virtual inline void seedDDAPts(NodeID id, const PointsTo& pts) {
+        CxtPtSet cpts;
+        ContextCond cxt;
+        for (PointsTo::iterator piter = pts.begin(); piter != pts.end(); ++piter) {
+            CxtVar var(cxt,*piter);
+            cpts.set(var);
+        }
+        CxtVar var(cxt, id);
+        unionPts(var, cpts);
+    }
+    //@}
+
     /// Override parent method
     CxtPtSet getConservativeCPts(const CxtLocDPItem& dpm) {
         const PointsTo& pts =  getAndersenAnalysis()->getPts(dpm.getCurNodeID());
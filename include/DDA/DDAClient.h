@@ -68,10 +68,33 @@ public:
     }
     virtual void answerQueries(PointerAnalysis* pta);
 
+    /// Answer a batch of queries, skipping those answered before
+    void answerQueries(PointerAnalysis* pta, const NodeVector& queries);
+
+    /// Store/load the points-to of the answered queries, so that a later
+    /// run on the same module with the same options can skip them
+    //@{
+    void writeQueryResults(PointerAnalysis* pta, const std::string& filename) const;
+    bool readQueryResults(PointerAnalysis* pta, const std::string& filename);
+    //@}
+    /// Check the answered queries are read back as they were stored (-check-dda-queries)
+    void validateQueryResultsTests(PointerAnalysis* pta) const;
+    /// Forget the answered queries, before answering them with another analysis
+    inline void clearAnsweredQueries() {
+        answeredQueries.clear();
+    }
+
     virtual inline void performStat(PointerAnalysis* pta) {}
 
     virtual inline void collectWPANum(SVFModule mod) {}
 protected:
+    typedef std::map<NodeID, PointsTo> QueryResults;
+
+    /// Write the points-to of the answered queries to os
+    void writeQueryResults(PointerAnalysis* pta, raw_ostream& os) const;
+    /// Parse the query results stored in a file, without seeding them
+    bool parseQueryResults(PointerAnalysis* pta, const std::string& filename, QueryResults& results) const;
+
     void addCandidate(NodeID id) {
         if (pag->isValidTopLevelPtr(pag->getPAGNode(id)))
             candidateQueries.insert(id);
@@ -81,6 +104,7 @@ protected:
     SVFModule module;		///< LLVM module
     NodeID curPtr;				///< current pointer being queried
     NodeSet candidateQueries;	///< store all candidate pointers to be queried
+    NodeBS answeredQueries;		///< pointers answered in this run or loaded from a previous one
 
 private:
     NodeSet userInput;           ///< User input queries
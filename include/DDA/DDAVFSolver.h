@@ -498,6 +498,41 @@ protected:
         }
         _svfgSCC->find();
     }
+    /// Sort pointers in the topological order of their definitions on the
+    /// SVFG, so that the pointers a query reaches backward are queried, and
+    /// their points-to cached, before it. Pointers without a definition go
+    /// last, in their original order.
+    inline void sortQueriesInTopoOrder(NodeVector& queries) {
+        if (_svfgSCC == NULL)
+            SVFGSCCDetection();
+
+        DenseMap<NodeID, u32_t> topoOrder;
+        typename SVFGSCC::GNodeStack topoStack = _svfgSCC->topoNodeStack();
+        for (u32_t i = 0; !topoStack.empty(); ++i) {
+            topoOrder[topoStack.top()] = i;
+            topoStack.pop();
+        }
+
+        u32_t undefOrder = topoOrder.size();
+        std::vector<std::pair<u32_t, NodeID> > orderedQueries;
+        for (NodeVector::const_iterator it = queries.begin(), eit = queries.end(); it != eit; ++it) {
+            const PAGNode* pagNode = _pag->getPAGNode(*it);
+            u32_t order = undefOrder;
+            if (getSVFG()->hasDefSVFGNode(pagNode)) {
+                const SVFGNode* def = getDefSVFGNode(pagNode);
+                DenseMap<NodeID, u32_t>::const_iterator oit = topoOrder.find(getSVFGSCCRepNode(def->getId()));
+                if (oit != topoOrder.end())
+                    order = oit->second;
+            }
+            orderedQueries.push_back(std::make_pair(order, *it));
+        }
+        std::stable_sort(orderedQueries.begin(), orderedQueries.end(),
+        [](const std::pair<u32_t, NodeID>& a, const std::pair<u32_t, NodeID>& b) {
+            return a.first < b.first;
+        });
+        for (u32_t i = 0; i < orderedQueries.size(); ++i)
+            queries[i] = orderedQueries[i].second;
+    }
     /// Get SCC rep node of a SVFG node.
     inline NodeID getSVFGSCCRepNode(NodeID id) {
         return _svfgSCC->repNode(id);
@@ -42,6 +42,16 @@ public:
     /// Handle out-of-budget dpm
     void handleOutOfBudgetDpm(const LocDPItem& dpm);
 
+    /// Batched queries
+    //@{
+    virtual inline void orderDDAQueries(NodeVector& queries) {
+        sortQueriesInTopoOrder(queries);
+    }
+    virtual inline void seedDDAPts(NodeID id, const PointsTo& pts) {
+        unionPts(id, pts);
+    }
+    //@}
+
     /// Handle condition for flow analysis (backward analysis)
     virtual bool handleBKCondition(LocDPItem& dpm, const SVFGEdge* edge);
 
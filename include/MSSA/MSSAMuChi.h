@@ -31,6 +31,7 @@
 #define MSSAMUCHI_H_
 
 #include "MSSA/MemRegion.h"
+#include <atomic>
 
 
 class MSSADEF;
@@ -43,8 +44,8 @@ class MRVer {
 public:
     typedef MSSADEF MSSADef;
 private:
-    /// ver ID 0 is reserved
-    static Size_t totalVERNum;
+    /// ver ID 0 is reserved. Versions may be created on several threads.
+    static std::atomic<Size_t> totalVERNum;
     const MemRegion* mr;
     VERSION version;
     MRVERID vid;
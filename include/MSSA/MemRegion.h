@@ -317,12 +317,12 @@ protected:
     inline void addCPtsToStore(PointsTo& cpts, const StorePE *st, const Function* fun) {
         storesToPointsToMap[st] = cpts;
         funToPointsToMap[fun].insert(cpts);
-        addModSideEffectOfFunction(fun,cpts);
+        addModSideEffectOfFunction(fun,cpts.toNodeBS());
     }
     inline void addCPtsToLoad(PointsTo& cpts, const LoadPE *ld, const Function* fun) {
         loadsToPointsToMap[ld] = cpts;
         funToPointsToMap[fun].insert(cpts);
-        addRefSideEffectOfFunction(fun,cpts);
+        addRefSideEffectOfFunction(fun,cpts.toNodeBS());
     }
     inline void addCPtsToCallSiteRefs(PointsTo& cpts, CallSite cs) {
         callsiteToRefPointsToMap[cs] = cpts;
@@ -139,6 +139,21 @@ private:
     MRSet varKills;
     //@}
 
+    /// The MemSSA this one builds functions for on a thread, or NULL
+    MemSSA* owner;
+
+    /// Constructor of a MemSSA building functions for owner on a thread
+    MemSSA(MemSSA* owner);
+
+    /// Move the mus, chis and phis built into mssa
+    void moveInto(MemSSA* mssa);
+
+    /// Warnings of the function being built on a thread, printed by owner
+    std::vector<std::string> pendingWarnings;
+
+    /// Print a warning, or keep it in pendingWarnings on a thread
+    void warn(const std::string& msg);
+
     /// Release the memory
     void destroy();
 
@@ -288,6 +303,10 @@ public:
     }
     /// We start from here
     virtual void buildMemSSA(const Function& fun,DominanceFrontier*, DominatorTree*);
+    /// Build memory SSA for funs on numThreads threads
+    void buildMemSSA(const std::vector<Function*>& funs, u32_t numThreads);
+    /// Check the memory SSA of funs is the one built on a single thread
+    void validateParallelTests(const std::vector<Function*>& funs);
 
     /// Perform statistics
     void performStat();
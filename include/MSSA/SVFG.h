@@ -159,6 +159,10 @@ public:
     inline const SVFGNode* getDefSVFGNode(const PAGNode* pagNode) const {
         return getSVFGNode(getDef(pagNode));
     }
+    /// Whether a pagNode has a definition site
+    inline bool hasDefSVFGNode(const PAGNode* pagNode) const {
+        return hasDef(pagNode);
+    }
 
     /// Perform statistics
     void performStat();
@@ -323,6 +327,35 @@ protected:
     void addSVFGNodesForAddrTakenVars();
     /// Connect direct SVFG edges between two SVFG nodes (value-flow of top address-taken variables)
     void connectIndirectSVFGEdges();
+    /// An indirect edge into a node, found before being added to the graph
+    struct IndirectEdgeInfo {
+        enum Kind {
+            Intra, Call, Ret
+        };
+        Kind kind;
+        NodeID src;
+        NodeID dst;
+        CallSiteID csId;
+        PointsTo cpts;
+        IndirectEdgeInfo(Kind k, NodeID s, NodeID d, const PointsTo& pts, CallSiteID id = 0) :
+            kind(k), src(s), dst(d), csId(id), cpts(pts) {
+        }
+    };
+    typedef std::vector<IndirectEdgeInfo> IndirectEdgeInfos;
+    typedef std::vector<std::pair<NodeID, const SVFGNode*> > IDToSVFGNodeList;
+    /// Find the indirect edges connecting node. They are collected into edges
+    /// without modifying the graph, or added straight away if edges is NULL.
+    void collectIndirectSVFGEdges(NodeID nodeId, const SVFGNode* node, IndirectEdgeInfos* edges);
+    /// Collect an indirect edge into edges, or add it if edges is NULL
+    void collectIndirectSVFGEdge(IndirectEdgeInfo::Kind kind, NodeID src, NodeID dst, const PointsTo& cpts,
+                                 CallSiteID csId, IndirectEdgeInfos* edges);
+    /// Add an indirect edge of the given kind to the graph
+    void addIndirectSVFGEdge(IndirectEdgeInfo::Kind kind, NodeID src, NodeID dst, const PointsTo& cpts, CallSiteID csId);
+    /// Check the edges collected on several threads are those collected on one
+    void validateParallelTests(const IDToSVFGNodeList& nodes, const std::vector<IndirectEdgeInfos>& edges);
+    /// Points-to carried from an actual-in (formal-out) to a formal-in (actual-out)
+    /// node: the intersection of their points-to. Returns false if it is empty.
+    static bool getInterIndirectVFPts(const PointsTo& srcPts, const PointsTo& dstPts, PointsTo& cpts);
     /// Connect indirect SVFG edges from global initializers (store) to main function entry
     void connectFromGlobalToProgEntry();
 
@@ -20,6 +20,10 @@
 #include "Util/SVFUtil.h"
 #include "Util/WorkList.h"
 
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/Hashing.h>
+#include <unordered_map>
+
 class SVFModule;
 class DCHNode;
 
@@ -168,6 +172,57 @@ private:
     std::vector<std::vector<const Function*>> vfnVectors;
 };
 
+/// Relation between the types of a DCHG, indexed by node IDs, filled as it
+/// is queried. Each pair takes two bits (whether it is known and whether it
+/// holds); a row is only allocated once its first type is queried.
+class DCHTypeRelation {
+public:
+    /// Returns whether the relation is known for (a, b), setting holds if so.
+    inline bool lookup(NodeID a, NodeID b, bool &holds) const {
+        if (a >= rows.size() || 2 * b >= rows[a].size()) {
+            return false;
+        }
+
+        const llvm::BitVector &row = rows[a];
+        if (!row.test(2 * b)) {
+            return false;
+        }
+
+        holds = row.test(2 * b + 1);
+        return true;
+    }
+
+    /// Records whether the relation holds for (a, b).
+    inline void set(NodeID a, NodeID b, bool holds) {
+        if (a >= rows.size()) {
+            rows.resize(a + 1);
+        }
+
+        llvm::BitVector &row = rows[a];
+        if (2 * b >= row.size()) {
+            row.resize(2 * (b + 1));
+        }
+
+        row.set(2 * b);
+        if (holds) {
+            row.set(2 * b + 1);
+        }
+    }
+
+    /// Bounds of the pairs recorded: a below getNumRows(), b below getRowLength(a).
+    //@{
+    inline NodeID getNumRows(void) const {
+        return rows.size();
+    }
+    inline NodeID getRowLength(NodeID a) const {
+        return rows[a].size() / 2;
+    }
+    //@}
+
+private:
+    std::vector<llvm::BitVector> rows;
+};
+
 /// Dwarf based CHG.
 class DCHGraph : public CommonCHGraph, public GenericGraph<DCHNode, DCHEdge> {
 public:
@@ -186,6 +241,9 @@ public:
     ///   DISubroutineType: shallow pointer equality.
     static bool teq(const DIType *t1, const DIType *t2);
 
+    /// Returns a structural hash of t such that teq types have equal hashes.
+    static size_t hashType(const DIType *t);
+
     /// Returns a human-readable version of the DIType.
     static std::string diTypeToStr(const DIType *);
 
@@ -314,6 +372,14 @@ public:
 
     bool isFirstField(const DIType *f, const DIType *b);
 
+    /// Checks every memoised isBase, isFirstField, and isFieldOf against
+    /// its uncached computation.
+    void validateRelationTests(void);
+
+    /// Checks the canonical types interned by hash are those a linear teq
+    /// search over all canonical types gives.
+    void validateCanonicalTypeTests(void);
+
 protected:
     /// SVF Module this CHG is built from.
     SVFModule svfModule;
@@ -335,12 +401,22 @@ protected:
     DenseMap<const DIType *, const DIType *> canonicalTypeMap;
     /// Set of all possible canonical types (i.e. values of canonicalTypeMap).
     DenseSet<const DIType *> canonicalTypes;
+    /// Canonical types by their hashType, so new types are only compared (teq)
+    /// with the canonical types they can be equal to.
+    std::unordered_map<size_t, std::vector<const DIType *>> canonicalTypeBuckets;
     /// Maps types to their flattened fields' types.
     DenseMap<const DIType *, std::vector<const DIType *>> fieldTypes;
     /// Maps constructors to their (canonical) type.
     DenseMap<const Function *, const DIType *> constructorToType;
     /// Maps aggregate types to all the aggregate types it transitively contains.
     DenseMap<const DIType *, DenseSet<const DIType *>> containingAggs;
+    /// Memoised isBase without/with first-field edges, isFirstField, and isFieldOf.
+    //@{
+    DCHTypeRelation baseRelation;
+    DCHTypeRelation baseFFRelation;
+    DCHTypeRelation firstFieldRelation;
+    DCHTypeRelation fieldOfRelation;
+    //@}
 
 private:
     /// Construction helper to process DIBasicTypes.
@@ -395,6 +471,24 @@ private:
         return nullptr;
     }
 
+    /// Sets id to the node ID of the canonical type canonType. Returns false
+    /// if there is no node for it.
+    bool getCanonicalTypeID(const DIType *canonType, NodeID &id) const {
+        DenseMap<const DIType *, DCHNode *>::const_iterator it = diTypeToNodeMap.find(canonType);
+        if (it == diTypeToNodeMap.end() || it->second == nullptr) {
+            return false;
+        }
+
+        id = it->second->getId();
+        return true;
+    }
+
+    /// Uncached isFieldOf/isFirstField on canonical types.
+    //@{
+    bool computeIsFieldOf(const DIType *f, const DIType *b);
+    bool computeIsFirstField(const DIType *f, const DIType *b);
+    //@}
+
 
     /// Creates an edge between from t1 to t2.
     DCHEdge *addEdge(const DIType *t1, const DIType *t2, DCHEdge::GEdgeKind et);
@@ -31,6 +31,7 @@
 #define GENERICGRAPH_H_
 
 #include "Util/BasicTypes.h"
+#include "MemoryModel/GraphAllocator.h"
 
 /*!
  * Generic edge on the graph as base class
@@ -62,6 +63,16 @@ public:
     virtual ~GenericEdge() {
     }
 
+    /// Edges are allocated from the GraphAllocator pools
+    //@{
+    static inline void* operator new(size_t size) {
+        return GraphAllocator::allocate(size);
+    }
+    static inline void operator delete(void* ptr, size_t size) {
+        GraphAllocator::deallocate(ptr, size);
+    }
+    //@}
+
     ///  get methods of the components
     //@{
     inline NodeID getSrcID() const {
@@ -131,10 +142,11 @@ private:
 
     GEdgeSetTy InEdges; ///< all incoming edge of this node
     GEdgeSetTy OutEdges; ///< all outgoing edge of this node
+    bool outEdgesCompacted; ///< whether OutEdges are unchanged since the graph compacted them
 
 public:
     /// Constructor
-    GenericNode(NodeID i, GNodeK k): id(i),nodeKind(k) {
+    GenericNode(NodeID i, GNodeK k): id(i),nodeKind(k), outEdgesCompacted(false) {
 
     }
 
@@ -144,6 +156,16 @@ public:
             delete *it;
     }
 
+    /// Nodes are allocated from the GraphAllocator pools
+    //@{
+    static inline void* operator new(size_t size) {
+        return GraphAllocator::allocate(size);
+    }
+    static inline void operator delete(void* ptr, size_t size) {
+        GraphAllocator::deallocate(ptr, size);
+    }
+    //@}
+
     /// Get ID
     inline NodeID getId() const {
         return id;
@@ -237,7 +259,20 @@ public:
         return InEdges.insert(inEdge).second;
     }
     inline bool addOutgoingEdge(EdgeType* outEdge) {
-        return OutEdges.insert(outEdge).second;
+        if (!OutEdges.insert(outEdge).second)
+            return false;
+        outEdgesCompacted = false;
+        return true;
+    }
+    //@}
+
+    /// Whether the out edges compacted by the graph are up to date
+    //@{
+    inline bool hasCompactOutEdges() const {
+        return outEdgesCompacted;
+    }
+    inline void setOutEdgesCompacted(bool compacted) {
+        outEdgesCompacted = compacted;
     }
     //@}
 
@@ -251,6 +286,7 @@ public:
     inline Size_t removeOutgoingEdge(EdgeType* edge) {
         iterator it = OutEdges.find(edge);
         assert(it != OutEdges.end() && "can not find out edge in SVFG node");
+        outEdgesCompacted = false;
         return OutEdges.erase(edge);
     }
     ///@}
@@ -355,6 +391,101 @@ public:
         IDToNodeMap.erase(it);
     }
 
+    /// Compacted out edges: the out edges of all nodes copied into one array,
+    /// grouped by source node and then by edge kind, for cache-friendly
+    /// iteration once the graph is built. A node whose out edges change
+    /// afterwards is no longer compacted, and its edge set is to be used.
+    /// The edge sets are kept, so this costs memory on top of them (an edge
+    /// pointer and a node ID per edge, plus one offset per node).
+    //@{
+    void compactOutEdges() {
+        clearCompactOutEdges();
+        NodeID maxId = 0;
+        for (const_iterator it = IDToNodeMap.begin(), eit = IDToNodeMap.end(); it != eit; ++it)
+            maxId = std::max(maxId, it->first);
+
+        compactOffsets.assign(maxId + 2, 0);
+        for (const_iterator it = IDToNodeMap.begin(), eit = IDToNodeMap.end(); it != eit; ++it)
+            compactOffsets[it->first + 1] = it->second->getOutEdges().size();
+        for (NodeID id = 0; id <= maxId; ++id)
+            compactOffsets[id + 1] += compactOffsets[id];
+
+        compactEdges.resize(compactOffsets.back());
+        compactDstIDs.resize(compactOffsets.back());
+        for (iterator it = IDToNodeMap.begin(), eit = IDToNodeMap.end(); it != eit; ++it) {
+            NodeType* node = it->second;
+            typename std::vector<EdgeType*>::iterator begin = compactEdges.begin() + compactOffsets[it->first];
+            std::copy(node->getOutEdges().begin(), node->getOutEdges().end(), begin);
+            std::stable_sort(begin, begin + node->getOutEdges().size(), [](const EdgeType* lhs, const EdgeType* rhs) {
+                return lhs->getEdgeKind() < rhs->getEdgeKind();
+            });
+            for (u32_t i = compactOffsets[it->first]; i < compactOffsets[it->first + 1]; ++i)
+                compactDstIDs[i] = compactEdges[i]->getDstID();
+            node->setOutEdgesCompacted(true);
+        }
+    }
+    void clearCompactOutEdges() {
+        for (iterator it = IDToNodeMap.begin(), eit = IDToNodeMap.end(); it != eit; ++it)
+            it->second->setOutEdgesCompacted(false);
+        std::vector<u32_t>().swap(compactOffsets);
+        std::vector<EdgeType*>().swap(compactEdges);
+        std::vector<NodeID>().swap(compactDstIDs);
+    }
+    /// Get the indices [begin, end) of the compacted out edges of node.
+    /// Return false if they are not up to date.
+    inline bool getCompactOutEdges(const NodeType* node, u32_t& begin, u32_t& end) const {
+        if (!node->hasCompactOutEdges())
+            return false;
+        begin = compactOffsets[node->getId()];
+        end = compactOffsets[node->getId() + 1];
+        return true;
+    }
+    /// Get the indices [begin, end) of the compacted out edges of node of kind.
+    inline bool getCompactOutEdges(const NodeType* node, typename EdgeType::GEdgeKind kind, u32_t& begin, u32_t& end) const {
+        if (!getCompactOutEdges(node, begin, end))
+            return false;
+        typename std::vector<EdgeType*>::const_iterator first = compactEdges.begin() + begin;
+        typename std::vector<EdgeType*>::const_iterator last = compactEdges.begin() + end;
+        first = std::partition_point(first, last, [kind](const EdgeType* edge) {
+            return edge->getEdgeKind() < kind;
+        });
+        last = std::partition_point(first, last, [kind](const EdgeType* edge) {
+            return edge->getEdgeKind() == kind;
+        });
+        begin = first - compactEdges.begin();
+        end = last - compactEdges.begin();
+        return true;
+    }
+    inline EdgeType* getCompactEdge(u32_t i) const {
+        return compactEdges[i];
+    }
+    inline NodeID getCompactDstID(u32_t i) const {
+        return compactDstIDs[i];
+    }
+    /// Number of nodes flagged as compacted whose compacted out edges are not
+    /// their edge set grouped by kind
+    u32_t getNumOfStaleCompactOutEdges() const {
+        u32_t numOfStale = 0;
+        for (const_iterator it = IDToNodeMap.begin(), eit = IDToNodeMap.end(); it != eit; ++it) {
+            const NodeType* node = it->second;
+            u32_t begin, end;
+            if (!getCompactOutEdges(node, begin, end))
+                continue;
+            const typename NodeType::GEdgeSetTy& outEdges = node->getOutEdges();
+            bool stale = end - begin != outEdges.size();
+            for (u32_t i = begin; !stale && i < end; ++i) {
+                typename NodeType::const_iterator eit = outEdges.find(compactEdges[i]);
+                stale = eit == outEdges.end() || *eit != compactEdges[i]
+                        || compactDstIDs[i] != compactEdges[i]->getDstID()
+                        || (i > begin && compactEdges[i - 1]->getEdgeKind() > compactEdges[i]->getEdgeKind());
+            }
+            if (stale)
+                numOfStale++;
+        }
+        return numOfStale;
+    }
+    //@}
+
     /// Get total number of node/edge
     inline Size_t getTotalNodeNum() const {
         return nodeNum;
@@ -373,6 +504,14 @@ public:
 protected:
     IDToNodeMapTy IDToNodeMap; ///< node map
 
+private:
+    /// Compacted out edges
+    //@{
+    std::vector<u32_t> compactOffsets;	///< node ID to the index of its first compacted out edge
+    std::vector<EdgeType*> compactEdges;	///< compacted out edges
+    std::vector<NodeID> compactDstIDs;	///< destinations of the compacted out edges
+    //@}
+
 public:
     Size_t edgeNum;		///< total num of node
     Size_t nodeNum;		///< total num of edge
@@ -0,0 +1,112 @@
+//===- GraphAllocator.h -- Pooled memory for graph nodes and edges -----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * GraphAllocator.h
+ *
+ * Nodes and edges of the graphs (PAG, constraint graph, VFG/SVFG, ...) are
+ * created in the millions, one at a time, and almost all of them live until
+ * their graph is destroyed. GenericNode and GenericEdge take their memory
+ * from GraphAllocator instead of the heap: objects are bump-allocated from
+ * large slabs, with one pool per size class (so each node or edge kind
+ * effectively has its own pool), and freed objects are recycled by later
+ * allocations of the same size. Once every node and edge has been freed,
+ * e.g. when the graphs are torn down, the slabs are released at once.
+ *
+ * The allocator is not thread-safe: nodes and edges must be created and
+ * deleted on one thread, as they already are.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef GRAPHALLOCATOR_H_
+#define GRAPHALLOCATOR_H_
+
+#include "Util/BasicTypes.h"
+#include <vector>
+
+class GraphAllocator {
+public:
+    /// Allocate/free size bytes. Objects larger than MaxPooledSize are
+    /// passed to the heap.
+    //@{
+    static inline void* allocate(size_t size) {
+        return getAllocator().allocateFromPool(size);
+    }
+    static inline void deallocate(void* ptr, size_t size) {
+        getAllocator().deallocateToPool(ptr, size);
+    }
+    //@}
+
+    /// Statistics
+    //@{
+    static inline Size_t getNumOfLiveObjects() {
+        return getAllocator().numOfLiveObjects;
+    }
+    static inline Size_t getNumOfSlabs() {
+        return getAllocator().slabs.size();
+    }
+    //@}
+
+    /// Number of inconsistencies in the pools: free objects outside the
+    /// slabs or on a free list twice, and bytes taken from the slabs which
+    /// are neither live nor free
+    static inline u32_t getNumOfPoolErrors() {
+        return getAllocator().checkPools();
+    }
+
+private:
+    /// Pooled sizes are rounded up to a multiple of Granule.
+    static const size_t Granule = 16;
+    static const size_t MaxPooledSize = 512;
+    static const size_t SlabSize = 1 << 20;
+
+    /// A freed object, linked into the free list of its size class
+    struct FreeObject {
+        FreeObject* next;
+    };
+
+    GraphAllocator(): freeLists(MaxPooledSize / Granule + 1, NULL), cur(NULL), end(NULL), numOfLiveObjects(0),
+        numOfLiveBytes(0), numOfBumpedBytes(0) {
+    }
+
+    /// The allocator shared by all graphs
+    static GraphAllocator& getAllocator();
+
+    void* allocateFromPool(size_t size);
+    void deallocateToPool(void* ptr, size_t size);
+
+    /// Free all slabs; only valid once no object is live
+    void releaseSlabs();
+
+    u32_t checkPools() const;
+
+    std::vector<FreeObject*> freeLists;	///< free objects of each size class
+    std::vector<char*> slabs;	///< slabs allocated so far
+    char* cur;	///< next free byte of the current slab
+    char* end;	///< end of the current slab
+    Size_t numOfLiveObjects;	///< pooled objects allocated and not freed
+    Size_t numOfLiveBytes;	///< rounded sizes of the live pooled objects
+    Size_t numOfBumpedBytes;	///< bytes bump-allocated from the slabs
+};
+
+#endif /* GRAPHALLOCATOR_H_ */
@@ -62,6 +62,7 @@ public:
         AndersenSFR_WPA,    ///< Stride-based field representation
         AndersenWaveDiff_WPA,	///< Diff wave propagation andersen-style WPA
         AndersenWaveDiffWithType_WPA,	///< Diff wave propagation with type info andersen-style WPA
+        AndersenWaveDiffParallel_WPA,	///< Diff wave propagation andersen-style WPA propagating each wave in parallel
         CSCallString_WPA,	///< Call string based context sensitive WPA
         CSSummary_WPA,		///< Summary based context sensitive WPA
         FSDATAFLOW_WPA,	///< Traditional Dataflow-based flow sensitive WPA
@@ -215,6 +216,12 @@ public:
     /// Compute points-to results on-demand, overridden by derived classes
     virtual void computeDDAPts(NodeID id) {}
 
+    /// Order on-demand queries so that they best reuse each other's cached results
+    virtual void orderDDAQueries(NodeVector& queries) {}
+
+    /// Seed the points-to of a pointer with its on-demand result from a previous run
+    virtual void seedDDAPts(NodeID id, const PointsTo& pts) {}
+
     /// Interface exposed to users of our pointer analysis, given Location infos
     virtual AliasResult alias(const MemoryLocation &LocA,
                                     const MemoryLocation &LocB) = 0;
@@ -242,6 +249,9 @@ protected:
     virtual void validateExpectedFailureTests(const std::string fun);
     //@}
 
+    /// Check the pools of graph nodes and edges (-check-graph-alloc)
+    void validateGraphAllocTests();
+
     /// Whether to dump the graph for debugging purpose
     bool dumpGraph();
 
@@ -434,6 +444,8 @@ public:
     typedef DiffPTData<NodeID,PointsTo,EdgeID> DiffPTDataTy;	/// Points-to data structure type
     typedef DFPTData<NodeID,PointsTo> DFPTDataTy;	/// Points-to data structure type
     typedef IncDFPTData<NodeID,PointsTo> IncDFPTDataTy;	/// Points-to data structure type
+    typedef HCDFPTData<NodeID,PointsTo> HCDFPTDataTy;	/// Points-to data structure type
+    typedef FlatDFPTData<NodeID,PointsTo> FlatDFPTDataTy;	/// Points-to data structure type
 
     /// Constructor
     BVDataPTAImpl(PointerAnalysis::PTATY type);
@@ -461,11 +473,46 @@ public:
     virtual inline PointsTo& getRevPts(NodeID nodeId) {
         return ptD->getRevPts(nodeId);
     }
+    /// Points-to set of id without adding an empty one, NULL if it has none
+    virtual inline const PointsTo* findPts(NodeID id) const {
+        return ptD->findPts(id);
+    }
+    //@}
+
+    /// Pointed-by index, meant to be used after solving. Unlike getRevPts,
+    /// it covers every node (not only SCC reps) for every points-to data
+    /// structure. It is built from all points-to sets on first use.
+    //@{
+    /// Nodes whose points-to sets contain obj
+    const NodeBS& getPointedBy(NodeID obj);
+    /// Drop the index so that it is rebuilt from the current points-to sets
+    inline void invalidatePointedBy() {
+        pointedByMap.clear();
+        pointedByBuilt = false;
+    }
     //@}
 
     /// Expand FI objects
     virtual void expandFIObjs(const PointsTo& pts, PointsTo& expandedPts);
 
+    /// The two steps of alias(pts1, pts2), for callers which expand each set
+    /// once and then compare the expanded sets many times (in parallel).
+    //@{
+    /// Expand pts as alias does and tell whether the result has the black hole
+    void expandForAlias(const PointsTo& pts, PointsTo& expandedPts, bool& hasBlackHole);
+    /// Alias result of two sets given by expandForAlias
+    static inline AliasResult aliasOfExpanded(const PointsTo& expandedPts1, bool hasBlackHole1,
+            const PointsTo& expandedPts2, bool hasBlackHole2) {
+        if (hasBlackHole1 || hasBlackHole2 || expandedPts1.intersects(expandedPts2))
+            return llvm::MayAlias;
+        else
+            return llvm::NoAlias;
+    }
+    //@}
+
+    /// Self checks of the points-to data structures, each enabled by its own option
+    void validateBVDataTests();
+
     /// Interface for analysis result storage on filesystem.
     //@{
     virtual void writeToFile(const std::string& filename);
@@ -473,6 +520,28 @@ public:
     //@}
 
 protected:
+    /// A GepObjPN stored with the analysis results
+    struct StoredGepObj {
+        NodeID id;
+        NodeID base;
+        Size_t offset;
+    };
+    typedef std::vector<StoredGepObj> StoredGepObjs;
+
+    /// Parse the analysis results stored in filename into ptd and gepObjs,
+    /// leaving the PAG untouched
+    bool parseResultsFile(const std::string& filename, PTDataTy* ptd, StoredGepObjs& gepObjs);
+
+    /// Number of differences between the parsed results and the current ones
+    u32_t getNumOfStoredResultsDiffs(const PTDataTy& storedPtD, const StoredGepObjs& gepObjs, const std::string& source);
+
+    /// Text and binary formats of stored analysis results
+    //@{
+    void writeToTextFile(raw_ostream& os);
+    void writeToBinaryFile(raw_ostream& os);
+    bool readFromTextFile(const std::string& filename, PTDataTy* ptd, StoredGepObjs& gepObjs);
+    bool readFromBinaryFile(const char* begin, const char* end, PTDataTy* ptd, StoredGepObjs& gepObjs);
+    //@}
 
     /// Update callgraph. This should be implemented by its subclass.
     virtual inline bool updateCallGraph(const CallSiteToFunPtrMap& callsites) {
@@ -508,14 +577,35 @@ protected:
     /// Clear all data
     virtual inline void clearPts() {
         ptD->clear();
+        invalidatePointedBy();
     }
 
     /// On the fly call graph construction
     virtual void onTheFlyCallGraphSolve(const CallSiteToFunPtrMap& callsites, CallEdgeMap& newEdges);
 
+    /// Check every points-to set representation against NodeBS
+    void validatePtsRepTests();
+
+    /// Check the analysis results are read back as they were stored
+    void validateResultsIOTests();
+
+    /// Check the pointed-by index against a scan of all points-to sets
+    void validatePointedByTests();
+
+    /// Add to nodes the nodes whose points-to set is the one of id
+    virtual inline void getNodesSharingPts(NodeID id, NodeBS& nodes) {
+        nodes.set(id);
+    }
+
 private:
+    /// Build the pointed-by index
+    void buildPointedBy();
+
     /// Points-to data
     PTDataTy* ptD;
+    /// Object to the nodes pointing to it, built by buildPointedBy
+    DenseMap<NodeID, NodeBS> pointedByMap;
+    bool pointedByBuilt;
 
 public:
     /// Interface expose to users of our pointer analysis, given Location infos
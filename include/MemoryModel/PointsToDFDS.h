@@ -31,6 +31,8 @@
 #define POINTSTODSDF_H_
 
 #include "MemoryModel/PointsToDS.h"
+#include "Util/Parallel.h"
+#include <algorithm>
 
 
 /*!
@@ -52,7 +54,7 @@ public:
     DFPtsMap dfInPtsMap;	///< Data-flow IN set
     DFPtsMap dfOutPtsMap;	///< Data-flow OUT set
     /// Constructor
-    DFPTData(PTDataTy ty = (PTData<Key,Data>::DFPTD)): PTData<Key,Data>(ty) {
+    DFPTData(PTDataTy ty = (PTData<Key,Data>::DFPTD)): PTData<Key,Data>(ty), deferringDFInUpdates(false) {
     }
     /// Destructor
     virtual ~DFPTData() {
@@ -60,67 +62,101 @@ public:
 
     /// Determine whether the DF IN/OUT sets have ptsMap
     //@{
-    inline bool hasDFInSet(LocID loc) const {
+    virtual inline bool hasDFInSet(LocID loc) const {
         return (dfInPtsMap.find(loc) != dfInPtsMap.end());
     }
-    inline bool hasDFOutSet(LocID loc) const {
+    virtual inline bool hasDFOutSet(LocID loc) const {
         return (dfOutPtsMap.find(loc) != dfOutPtsMap.end());
     }
-    inline bool hasDFInSet(LocID loc,const Key& var) const {
+    virtual inline bool hasDFInSet(LocID loc,const Key& var) const {
         DFPtsMapconstIter it = dfInPtsMap.find(loc);
         if ( it == dfInPtsMap.end())
             return false;
         const PtsMap& ptsMap = it->second;
         return (ptsMap.find(var) != ptsMap.end());
     }
-    inline bool hasDFOutSet(LocID loc,const Key& var) const {
+    virtual inline bool hasDFOutSet(LocID loc,const Key& var) const {
         DFPtsMapconstIter it = dfOutPtsMap.find(loc);
         if ( it == dfOutPtsMap.end())
             return false;
         const PtsMap& ptsMap = it->second;
         return (ptsMap.find(var) != ptsMap.end());
     }
-    inline const PtsMap& getDFInPtsMap(LocID loc)  {
+    //@}
+
+    /// Return the IN/OUT maps. Subclasses not storing their sets in
+    /// dfInPtsMap/dfOutPtsMap override these.
+    //@{
+    virtual inline const PtsMap& getDFInPtsMap(LocID loc)  {
         return dfInPtsMap[loc];
     }
-    inline const PtsMap& getDFOutPtsMap(LocID loc)  {
+    virtual inline const PtsMap& getDFOutPtsMap(LocID loc)  {
         return dfOutPtsMap[loc];
     }
-    inline const DFPtsMap& getDFIn()  {
+    virtual inline const DFPtsMap& getDFIn()  {
         return dfInPtsMap;
     }
-    inline const DFPtsMap& getDFOut()  {
+    virtual inline const DFPtsMap& getDFOut()  {
         return dfOutPtsMap;
     }
     //@}
 
     /// Get points-to from data-flow IN/OUT set
     ///@{
-    inline Data& getDFInPtsSet(LocID loc, const Key& var) {
-        PtsMap& inSet = dfInPtsMap[loc];
-        return inSet[var];
+    virtual inline const Data& getDFInPtsSet(LocID loc, const Key& var) {
+        return getMutableDFInPtsSet(loc, var);
     }
-    inline Data& getDFOutPtsSet(LocID loc, const Key& var) {
-        PtsMap& outSet = dfOutPtsMap[loc];
-        return outSet[var];
+    virtual inline const Data& getDFOutPtsSet(LocID loc, const Key& var) {
+        return getMutableDFOutPtsSet(loc, var);
     }
     ///@}
 
+    /// Collect the locations which have an IN/OUT set, and the variables
+    /// which have a points-to set in the IN/OUT set of loc
+    //@{
+    virtual inline void getDFInLocs(NodeBS& locs) const {
+        for(DFPtsMapconstIter it = dfInPtsMap.begin(), eit = dfInPtsMap.end(); it!=eit; ++it)
+            locs.set(it->first);
+    }
+    virtual inline void getDFOutLocs(NodeBS& locs) const {
+        for(DFPtsMapconstIter it = dfOutPtsMap.begin(), eit = dfOutPtsMap.end(); it!=eit; ++it)
+            locs.set(it->first);
+    }
+    virtual inline void getDFInVars(LocID loc, NodeBS& vars) const {
+        DFPtsMapconstIter it = dfInPtsMap.find(loc);
+        if (it != dfInPtsMap.end())
+            getVars(it->second, vars);
+    }
+    virtual inline void getDFOutVars(LocID loc, NodeBS& vars) const {
+        DFPtsMapconstIter it = dfOutPtsMap.find(loc);
+        if (it != dfOutPtsMap.end())
+            getVars(it->second, vars);
+    }
+    //@}
+
     /// Update points-to for IN/OUT set
     /// IN[loc:var] represents the points-to of variable var from IN set of location loc
     /// union(ptsDst,ptsSrc) represents union ptsSrc to ptsDst
     //@{
     /// union (IN[dstLoc:dstVar], IN[srcLoc:srcVar])
     virtual inline bool updateDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return this->unionPts(getDFInPtsSet(dstLoc,dstVar), getDFInPtsSet(srcLoc,srcVar));
+        if (deferringDFInUpdates) {
+            deferDFInUpdate(srcLoc,srcVar,dstLoc,dstVar,false);
+            return false;
+        }
+        return this->unionDFInFromIn(srcLoc,srcVar,dstLoc,dstVar);
     }
     /// union (IN[dstLoc:dstVar], OUT[srcLoc:srcVar])
     virtual inline bool updateDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return this->unionPts(getDFInPtsSet(dstLoc,dstVar), getDFOutPtsSet(srcLoc,srcVar));
+        if (deferringDFInUpdates) {
+            deferDFInUpdate(srcLoc,srcVar,dstLoc,dstVar,true);
+            return false;
+        }
+        return this->unionDFInFromOut(srcLoc,srcVar,dstLoc,dstVar);
     }
     /// union (OUT[dstLoc:dstVar], IN[srcLoc:srcVar])
     virtual inline bool updateDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return this->unionPts(getDFOutPtsSet(dstLoc,dstVar), getDFInPtsSet(srcLoc,srcVar));
+        return this->unionDFOutFromIn(srcLoc,srcVar,dstLoc,dstVar);
     }
     /// union (IN[dstLoc::dstVar], OUT[srcLoc:srcVar]. It differs from the above method in that there's
     /// no flag check.
@@ -156,18 +192,77 @@ public:
     }
     /// Update address-taken variables OUT[dstLoc:dstVar] with points-to of top-level pointers
     virtual inline bool updateATVPts(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        return (this->unionPts(this->getDFOutPtsSet(dstLoc, dstVar), this->getPts(srcVar)));
+        return this->unionDFOutFromTLV(srcVar, dstLoc, dstVar);
     }
     virtual inline void clearAllDFOutUpdatedVar(LocID loc) {
     }
     //@}
 
+    /// Deferred updates of IN sets.
+    /// After beginDFInUpdates, updateDFInFromIn/updateDFInFromOut only record
+    /// the unions to do (and return false). commitDFInUpdates then applies
+    /// them on up to numThreads threads and collects the locations whose IN
+    /// set changed. Updates read the sets as they are when committed, so the
+    /// fixed point reached is the same as without deferring. With check, the
+    /// IN sets written on several threads are compared with the unions done
+    /// on one thread, and the number of sets which differ is returned.
+    //@{
+    inline void beginDFInUpdates() {
+        deferringDFInUpdates = true;
+    }
+    inline bool isDeferringDFInUpdates() const {
+        return deferringDFInUpdates;
+    }
+    inline u32_t commitDFInUpdates(NodeBS& changedLocs, u32_t numThreads, bool check = false) {
+        deferringDFInUpdates = false;
+        DFInUpdates updates;
+        updates.swap(dfInUpdates);
+
+        /// Nothing is applied yet, so the sets read are the ones of the commit.
+        std::map<std::pair<LocID, Key>, Data> expected;
+        if (check && numThreads > 1) {
+            for (u32_t i = 0; i < updates.size(); ++i) {
+                std::pair<LocID, Key> dst = std::make_pair(updates[i].dstLoc, updates[i].dstVar);
+                if (expected.find(dst) == expected.end())
+                    expected[dst] = this->getDFInPtsSet(dst.first, dst.second);
+            }
+            for (u32_t i = 0; i < updates.size(); ++i)
+                expected[std::make_pair(updates[i].dstLoc, updates[i].dstVar)] |= getDFInUpdateSrc(updates[i]);
+        }
+
+        std::vector<char> changed(updates.size(), false);
+        if (numThreads <= 1 || !applyDFInUpdatesInPlace(updates, changed, numThreads)) {
+            /// Applied one by one, later updates read what earlier ones wrote.
+            expected.clear();
+            for (u32_t i = 0; i < updates.size(); ++i)
+                changed[i] = applyDFInUpdate(updates[i]);
+        }
+
+        for (u32_t i = 0; i < updates.size(); ++i) {
+            if (changed[i]) {
+                setVarDFInSetUpdated(updates[i].dstLoc, updates[i].dstVar);
+                changedLocs.set(updates[i].dstLoc);
+            }
+        }
+
+        u32_t numOfMismatches = 0;
+        for (typename std::map<std::pair<LocID, Key>, Data>::const_iterator it = expected.begin(), eit = expected.end(); it != eit; ++it) {
+            if (this->getDFInPtsSet(it->first.first, it->first.second) != it->second)
+                ++numOfMismatches;
+        }
+        return numOfMismatches;
+    }
+    //@}
+
     //@{ Methods for support type inquiry through isa, cast, and dyn_cast:
     static inline bool classof(const DFPTData<Key,Data> *) {
         return true;
     }
     static inline bool classof(const PTData<Key,Data>* ptd) {
-        return ptd->getPTDTY() == PTData<Key,Data>::DFPTD;
+        return ptd->getPTDTY() == PTData<Key,Data>::DFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::IncDFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::HCDFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::FlatDFPTD;
     }
     //@}
 
@@ -186,11 +281,152 @@ public:
     //@}
 
 protected:
+    /// A union into IN[dstLoc:dstVar] from IN[srcLoc:srcVar] (or OUT[srcLoc:srcVar]
+    /// if fromOut) recorded by a deferred update.
+    struct DFInUpdate {
+        LocID srcLoc;
+        Key srcVar;
+        LocID dstLoc;
+        Key dstVar;
+        bool fromOut;
+    };
+    typedef std::vector<DFInUpdate> DFInUpdates;
+
     /// Union two points-to sets
     inline bool unionPts(Data& dstData, const Data& srcData) {
         return dstData |= srcData;
     }
 
+    /// Record a union into an IN set while updates are deferred
+    inline void deferDFInUpdate(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar, bool fromOut) {
+        DFInUpdate update = {srcLoc, srcVar, dstLoc, dstVar, fromOut};
+        dfInUpdates.push_back(update);
+    }
+
+    /// Called when IN[loc:var] changed by a deferred update
+    virtual inline void setVarDFInSetUpdated(LocID loc, const Key& var) {
+    }
+
+    /// Return IN[loc:var] to be written in place, creating it if needed, or
+    /// NULL if IN sets cannot be written in place. Creating a set may move
+    /// other sets.
+    virtual inline Data* getDFInPtsSetForUpdate(LocID loc, const Key& var) {
+        return &getMutableDFInPtsSet(loc, var);
+    }
+
+    /// Points-to sets stored in dfInPtsMap/dfOutPtsMap
+    //@{
+    inline Data& getMutableDFInPtsSet(LocID loc, const Key& var) {
+        PtsMap& inSet = dfInPtsMap[loc];
+        return inSet[var];
+    }
+    inline Data& getMutableDFOutPtsSet(LocID loc, const Key& var) {
+        PtsMap& outSet = dfOutPtsMap[loc];
+        return outSet[var];
+    }
+    //@}
+
+    /// Union points-to into the IN/OUT sets without any bookkeeping.
+    /// Subclasses storing IN/OUT sets differently override these.
+    //@{
+    /// IN[dstLoc:dstVar] = IN[dstLoc:dstVar] U IN[srcLoc:srcVar]
+    virtual inline bool unionDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getMutableDFInPtsSet(dstLoc,dstVar), getMutableDFInPtsSet(srcLoc,srcVar));
+    }
+    /// IN[dstLoc:dstVar] = IN[dstLoc:dstVar] U OUT[srcLoc:srcVar]
+    virtual inline bool unionDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getMutableDFInPtsSet(dstLoc,dstVar), getMutableDFOutPtsSet(srcLoc,srcVar));
+    }
+    /// OUT[dstLoc:dstVar] = OUT[dstLoc:dstVar] U IN[srcLoc:srcVar]
+    virtual inline bool unionDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getMutableDFOutPtsSet(dstLoc,dstVar), getMutableDFInPtsSet(srcLoc,srcVar));
+    }
+    /// OUT[dstLoc:dstVar] = OUT[dstLoc:dstVar] U pts(srcVar)
+    virtual inline bool unionDFOutFromTLV(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getMutableDFOutPtsSet(dstLoc,dstVar), this->getPts(srcVar));
+    }
+    //@}
+
+    /// Apply a deferred update
+    inline bool applyDFInUpdate(const DFInUpdate& update) {
+        if (update.fromOut)
+            return this->unionDFInFromOut(update.srcLoc, update.srcVar, update.dstLoc, update.dstVar);
+        return this->unionDFInFromIn(update.srcLoc, update.srcVar, update.dstLoc, update.dstVar);
+    }
+
+    /// Return the set a deferred update reads
+    inline const Data& getDFInUpdateSrc(const DFInUpdate& update) {
+        if (update.fromOut)
+            return this->getDFOutPtsSet(update.srcLoc, update.srcVar);
+        return this->getDFInPtsSet(update.srcLoc, update.srcVar);
+    }
+
+    /// Apply deferred updates on several threads. Sets are looked up (and
+    /// created) first; then each IN set is written by one thread, and sets
+    /// which are also read are copied beforehand so no thread reads a set
+    /// another one writes. Returns false, without applying anything, if IN
+    /// sets cannot be written in place.
+    bool applyDFInUpdatesInPlace(const DFInUpdates& updates, std::vector<char>& changed, u32_t numThreads) {
+        u32_t numOfUpdates = updates.size();
+        std::vector<char> hasSrc(numOfUpdates, false);
+        for (u32_t i = 0; i < numOfUpdates; ++i) {
+            if (getDFInUpdateSrc(updates[i]).empty())
+                continue;
+            if (getDFInPtsSetForUpdate(updates[i].dstLoc, updates[i].dstVar) == NULL)
+                return false;
+            hasSrc[i] = true;
+        }
+
+        /// All sets exist now, so nothing moves from here on.
+        std::vector<u32_t> order;
+        std::vector<Data*> dsts(numOfUpdates, NULL);
+        std::vector<const Data*> srcs(numOfUpdates, NULL);
+        for (u32_t i = 0; i < numOfUpdates; ++i) {
+            if (!hasSrc[i])
+                continue;
+            dsts[i] = getDFInPtsSetForUpdate(updates[i].dstLoc, updates[i].dstVar);
+            srcs[i] = &getDFInUpdateSrc(updates[i]);
+            order.push_back(i);
+        }
+
+        std::sort(order.begin(), order.end(), [&dsts](u32_t lhs, u32_t rhs) {
+            return dsts[lhs] < dsts[rhs];
+        });
+        std::vector<u32_t> groupBegins;
+        std::vector<const Data*> written;
+        for (u32_t i = 0; i < order.size(); ++i) {
+            if (i == 0 || dsts[order[i]] != dsts[order[i - 1]]) {
+                groupBegins.push_back(i);
+                written.push_back(dsts[order[i]]);
+            }
+        }
+        groupBegins.push_back(order.size());
+
+        std::map<const Data*, Data> srcCopies;
+        for (u32_t i = 0; i < order.size(); ++i) {
+            const Data*& src = srcs[order[i]];
+            if (std::binary_search(written.begin(), written.end(), src)) {
+                typename std::map<const Data*, Data>::iterator it = srcCopies.find(src);
+                if (it == srcCopies.end())
+                    it = srcCopies.insert(std::make_pair(src, *src)).first;
+                src = &it->second;
+            }
+        }
+
+        SVFUtil::parallelFor(0, groupBegins.size() - 1, [&](u32_t group) {
+            for (u32_t i = groupBegins[group]; i < groupBegins[group + 1]; ++i)
+                changed[order[i]] = this->unionPts(*dsts[order[i]], *srcs[order[i]]);
+        }, numThreads);
+        return true;
+    }
+
+    /// Collect the variables of ptsMap
+    template<class Map>
+    static inline void getVars(const Map& ptsMap, NodeBS& vars) {
+        for (typename Map::const_iterator it = ptsMap.begin(), eit = ptsMap.end(); it != eit; ++it)
+            vars.set(it->first);
+    }
+
 public:
     /// Dump the DF IN/OUT set information for debugging purpose
     //@{
@@ -203,23 +439,26 @@ public:
         if (!ErrInfo) {
             raw_fd_ostream & osm = F.os();
             NodeBS locs;
-            for(DFPtsMapconstIter it = dfInPtsMap.begin(), eit = dfInPtsMap.end(); it!=eit; ++it)
-                locs.set(it->first);
-
-            for(DFPtsMapconstIter it = dfOutPtsMap.begin(), eit = dfOutPtsMap.end(); it!=eit; ++it)
-                locs.set(it->first);
+            this->getDFInLocs(locs);
+            this->getDFOutLocs(locs);
 
             for (NodeBS::iterator it = locs.begin(), eit = locs.end(); it != eit; it++) {
                 LocID loc = *it;
                 if (this->hasDFInSet(loc)) {
+                    NodeBS vars;
+                    this->getDFInVars(loc, vars);
                     osm << "Loc:" << loc << " IN:{";
-                    this->dumpPts(this->getDFInPtsMap(loc), osm);
+                    for (NodeBS::iterator vit = vars.begin(), veit = vars.end(); vit != veit; ++vit)
+                        this->dumpPts(*vit, this->getDFInPtsSet(loc, *vit), osm);
                     osm << "}\n";
                 }
 
                 if (this->hasDFOutSet(loc)) {
+                    NodeBS vars;
+                    this->getDFOutVars(loc, vars);
                     osm << "Loc:" << loc << " OUT:{";
-                    this->dumpPts(this->getDFOutPtsMap(loc), osm);
+                    for (NodeBS::iterator vit = vars.begin(), veit = vars.end(); vit != veit; ++vit)
+                        this->dumpPts(*vit, this->getDFOutPtsSet(loc, *vit), osm);
                     osm << "}\n";
                 }
             }
@@ -235,18 +474,21 @@ public:
     }
 
     virtual inline void dumpPts(const PtsMap & ptsSet,raw_ostream & O = SVFUtil::outs()) const {
-        for (PtsMapConstIter nodeIt = ptsSet.begin(); nodeIt != ptsSet.end(); nodeIt++) {
-            const Key& var = nodeIt->first;
-            const Data & pts = nodeIt->second;
-            if (pts.empty())
-                continue;
-            O << "<" << var << ",{";
-            SVFUtil::dumpSet(pts,O);
-            O << "}> ";
-        }
+        for (PtsMapConstIter nodeIt = ptsSet.begin(); nodeIt != ptsSet.end(); nodeIt++)
+            dumpPts(nodeIt->first, nodeIt->second, O);
+    }
+    inline void dumpPts(const Key& var, const Data& pts, raw_ostream & O) const {
+        if (pts.empty())
+            return;
+        O << "<" << var << ",{";
+        SVFUtil::dumpSet(pts,O);
+        O << "}> ";
     }
     //@}
 
+private:
+    DFInUpdates dfInUpdates;	///< Updates recorded since beginDFInUpdates
+    bool deferringDFInUpdates;	///< Whether updates of IN sets are deferred
 };
 
 /*!
@@ -279,8 +521,13 @@ public:
     //@{
     /// union (IN[dstLoc:dstVar], IN[srcLoc:srcVar])
     inline bool updateDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if(varHasNewDFInPts(srcLoc, srcVar) &&
-                this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFInPtsSet(srcLoc,srcVar))) {
+        if(!varHasNewDFInPts(srcLoc, srcVar))
+            return false;
+        if(this->isDeferringDFInUpdates()) {
+            this->deferDFInUpdate(srcLoc,srcVar,dstLoc,dstVar,false);
+            return false;
+        }
+        if(this->unionDFInFromIn(srcLoc,srcVar,dstLoc,dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -288,8 +535,13 @@ public:
     }
     /// union (IN[dstLoc:dstVar], OUT[srcLoc:srcVar])
     inline bool updateDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if(varHasNewDFOutPts(srcLoc, srcVar) &&
-                this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFOutPtsSet(srcLoc,srcVar))) {
+        if(!varHasNewDFOutPts(srcLoc, srcVar))
+            return false;
+        if(this->isDeferringDFInUpdates()) {
+            this->deferDFInUpdate(srcLoc,srcVar,dstLoc,dstVar,true);
+            return false;
+        }
+        if(this->unionDFInFromOut(srcLoc,srcVar,dstLoc,dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -299,7 +551,7 @@ public:
     inline bool updateDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
         if(varHasNewDFInPts(srcLoc,srcVar)) {
             removeVarFromDFInUpdatedSet(srcLoc,srcVar);
-            if (this->unionPts(this->getDFOutPtsSet(dstLoc,dstVar), this->getDFInPtsSet(srcLoc,srcVar))) {
+            if (this->unionDFOutFromIn(srcLoc,srcVar,dstLoc,dstVar)) {
                 setVarDFOutSetUpdated(dstLoc,dstVar);
                 return true;
             }
@@ -310,7 +562,7 @@ public:
     /// union (IN[dstLoc::dstVar], OUT[srcLoc:srcVar]. It differs from the above method in that there's
     /// no flag check.
     inline bool updateAllDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if(this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFOutPtsSet(srcLoc,srcVar))) {
+        if(this->unionDFInFromOut(srcLoc,srcVar,dstLoc,dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -319,7 +571,7 @@ public:
     /// union (IN[dstLoc::dstVar], IN[srcLoc:srcVar]. It differs from the above method in that there's
     /// no flag check.
     inline bool updateAllDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if(this->unionPts(this->getDFInPtsSet(dstLoc,dstVar), this->getDFInPtsSet(srcLoc,srcVar))) {
+        if(this->unionDFInFromIn(srcLoc,srcVar,dstLoc,dstVar)) {
             setVarDFInSetUpdated(dstLoc,dstVar);
             return true;
         }
@@ -353,7 +605,7 @@ public:
     }
     /// Update address-taken variables OUT[dstLoc:dstVar] with points-to of top-level pointers
     virtual inline bool updateATVPts(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
-        if (this->unionPts(this->getDFOutPtsSet(dstLoc, dstVar), this->getPts(srcVar))) {
+        if (this->unionDFOutFromTLV(srcVar, dstLoc, dstVar)) {
             setVarDFOutSetUpdated(dstLoc, dstVar);
             return true;
         }
@@ -367,11 +619,15 @@ public:
         return true;
     }
     static inline bool classof(const DFPTData<Key,Data> * ptd) {
-        return ptd->getPTDTY() == PTData<Key,Data>::IncDFPTD;
+        return ptd->getPTDTY() == PTData<Key,Data>::IncDFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::HCDFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::FlatDFPTD;
     }
     static inline bool classof(const PTData<Key,Data>* ptd) {
         return ptd->getPTDTY() == PTData<Key,Data>::IncDFPTD ||
-               ptd->getPTDTY() == PTData<Key,Data>::DFPTD;
+               ptd->getPTDTY() == PTData<Key,Data>::DFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::HCDFPTD ||
+               ptd->getPTDTY() == PTData<Key,Data>::FlatDFPTD;
     }
     //@}
 
@@ -436,4 +692,301 @@ private:
     //@}
 };
 
+/*!
+ * Incremental data-flow points-to data whose IN/OUT sets are hash-consed.
+ * IN/OUT sets are PointsTo::HCS sets kept in dfInPtsMap/dfOutPtsMap, so
+ * identical sets at different locations share one copy, and unions of two
+ * sets are computed once and then looked up (see PointsTo::HCS).
+ * Data must be PointsTo.
+ */
+template<class Key, class Data>
+class HCDFPTData : public IncDFPTData<Key,Data> {
+public:
+    typedef typename DFPTData<Key,Data>::LocID LocID;
+    typedef typename DFPTData<Key,Data>::PtsMap PtsMap;
+    typedef typename DFPTData<Key,Data>::DFPtsMap DFPtsMap;
+    typedef typename PTData<Key,Data>::PTDataTY PTDataTy;
+
+    /// Constructor
+    HCDFPTData(PTDataTy ty = (PTData<Key,Data>::HCDFPTD)): IncDFPTData<Key,Data>(ty) {
+    }
+    /// Destructor
+    virtual ~HCDFPTData() {
+    }
+
+    /// Get points-to from data-flow IN/OUT set
+    ///@{
+    inline const Data& getDFInPtsSet(LocID loc, const Key& var) {
+        return getHCPtsSet(this->dfInPtsMap, loc, var);
+    }
+    inline const Data& getDFOutPtsSet(LocID loc, const Key& var) {
+        return getHCPtsSet(this->dfOutPtsMap, loc, var);
+    }
+    ///@}
+
+    ///Methods for support type inquiry through isa, cast, and dyn_cast:
+    //@{
+    static inline bool classof(const HCDFPTData<Key,Data> *) {
+        return true;
+    }
+    static inline bool classof(const PTData<Key,Data>* ptd) {
+        return ptd->getPTDTY() == PTData<Key,Data>::HCDFPTD;
+    }
+    //@}
+
+protected:
+    /// Union points-to into the IN/OUT sets: a comparison of canonical sets
+    /// plus a lookup in the union cache of PointsTo::HCS.
+    //@{
+    inline bool unionDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getHCPtsSet(this->dfInPtsMap, dstLoc, dstVar), getHCPtsSet(this->dfInPtsMap, srcLoc, srcVar));
+    }
+    inline bool unionDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getHCPtsSet(this->dfInPtsMap, dstLoc, dstVar), getHCPtsSet(this->dfOutPtsMap, srcLoc, srcVar));
+    }
+    inline bool unionDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getHCPtsSet(this->dfOutPtsMap, dstLoc, dstVar), getHCPtsSet(this->dfInPtsMap, srcLoc, srcVar));
+    }
+    inline bool unionDFOutFromTLV(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return this->unionPts(getHCPtsSet(this->dfOutPtsMap, dstLoc, dstVar), this->getPts(srcVar));
+    }
+    //@}
+
+    /// HCS sets must only be used by one thread, so IN sets are never
+    /// written in place by parallel updates.
+    inline Data* getDFInPtsSetForUpdate(LocID loc, const Key& var) {
+        return NULL;
+    }
+
+private:
+    /// Return the set of var at loc in map, creating an empty HCS set if needed
+    static inline Data& getHCPtsSet(DFPtsMap& map, LocID loc, const Key& var) {
+        PtsMap& ptsMap = map[loc];
+        typename PtsMap::iterator it = ptsMap.find(var);
+        if (it == ptsMap.end())
+            it = ptsMap.insert(std::make_pair(var, Data(Data::HCS))).first;
+        return it->second;
+    }
+};
+
+/*!
+ * Incremental data-flow points-to data with flat, ID-indexed IN/OUT sets.
+ * Locations (SVFG node IDs) are dense, so IN/OUT sets are kept in vectors
+ * indexed by location. Each location has a row of variables sorted by ID
+ * with their points-to sets in a parallel vector, so a lookup is an index
+ * plus a binary search over contiguous keys instead of two tree walks.
+ * Looking up a missing set does not create it.
+ * dfInPtsMap/dfOutPtsMap of DFPTData are unused, so the map accessors of
+ * DFPTData must not be called; use getDFInVars/getDFInPtsSet etc. instead.
+ */
+template<class Key, class Data>
+class FlatDFPTData : public IncDFPTData<Key,Data> {
+public:
+    typedef typename DFPTData<Key,Data>::LocID LocID;
+    typedef typename DFPTData<Key,Data>::PtsMap PtsMap;
+    typedef typename DFPTData<Key,Data>::DFPtsMap DFPtsMap;
+    typedef typename PTData<Key,Data>::PTDataTY PTDataTy;
+    typedef std::vector<Key> KeyVector;
+    typedef std::vector<Data> DataVector;
+    /// Points-to sets of one location, sorted by variable
+    struct PtsRow {
+        KeyVector vars;
+        DataVector pts;
+    };
+    typedef std::vector<PtsRow> DFPtsRows;	///< Location -> its row
+
+    /// Constructor
+    FlatDFPTData(PTDataTy ty = (PTData<Key,Data>::FlatDFPTD)): IncDFPTData<Key,Data>(ty) {
+    }
+    /// Destructor
+    virtual ~FlatDFPTData() {
+    }
+
+    /// Determine whether the DF IN/OUT sets have ptsMap
+    //@{
+    inline bool hasDFInSet(LocID loc) const {
+        return loc < dfInRows.size() && !dfInRows[loc].vars.empty();
+    }
+    inline bool hasDFOutSet(LocID loc) const {
+        return loc < dfOutRows.size() && !dfOutRows[loc].vars.empty();
+    }
+    inline bool hasDFInSet(LocID loc,const Key& var) const {
+        return findPts(dfInRows, loc, var) != NULL;
+    }
+    inline bool hasDFOutSet(LocID loc,const Key& var) const {
+        return findPts(dfOutRows, loc, var) != NULL;
+    }
+    //@}
+
+    /// Get points-to from data-flow IN/OUT set
+    ///@{
+    inline const Data& getDFInPtsSet(LocID loc, const Key& var) {
+        const Data* pts = findPts(dfInRows, loc, var);
+        return pts ? *pts : emptyPts;
+    }
+    inline const Data& getDFOutPtsSet(LocID loc, const Key& var) {
+        const Data* pts = findPts(dfOutRows, loc, var);
+        return pts ? *pts : emptyPts;
+    }
+    ///@}
+
+    /// Collect locations and variables which have IN/OUT sets
+    //@{
+    inline void getDFInLocs(NodeBS& locs) const {
+        getLocs(dfInRows, locs);
+    }
+    inline void getDFOutLocs(NodeBS& locs) const {
+        getLocs(dfOutRows, locs);
+    }
+    inline void getDFInVars(LocID loc, NodeBS& vars) const {
+        getVars(dfInRows, loc, vars);
+    }
+    inline void getDFOutVars(LocID loc, NodeBS& vars) const {
+        getVars(dfOutRows, loc, vars);
+    }
+    //@}
+
+    /// IN/OUT sets are not kept in maps
+    //@{
+    inline const PtsMap& getDFInPtsMap(LocID loc) {
+        assert(false && "FlatDFPTData has no IN maps, use getDFInVars/getDFInPtsSet");
+        return this->dfInPtsMap[loc];
+    }
+    inline const PtsMap& getDFOutPtsMap(LocID loc) {
+        assert(false && "FlatDFPTData has no OUT maps, use getDFOutVars/getDFOutPtsSet");
+        return this->dfOutPtsMap[loc];
+    }
+    inline const DFPtsMap& getDFIn() {
+        assert(false && "FlatDFPTData has no IN maps, use getDFInLocs/getDFInVars");
+        return this->dfInPtsMap;
+    }
+    inline const DFPtsMap& getDFOut() {
+        assert(false && "FlatDFPTData has no OUT maps, use getDFOutLocs/getDFOutVars");
+        return this->dfOutPtsMap;
+    }
+    //@}
+
+    /// Clear maps
+    virtual void clear() {
+        IncDFPTData<Key,Data>::clear();
+        dfInRows.clear();
+        dfOutRows.clear();
+    }
+
+    /// Return the number of IN/OUT rows which are not sorted, have variables
+    /// and points-to sets out of step, or have sets lookups do not find
+    inline u32_t getNumOfBrokenRows() const {
+        return getNumOfBrokenRows(dfInRows) + getNumOfBrokenRows(dfOutRows);
+    }
+
+    ///Methods for support type inquiry through isa, cast, and dyn_cast:
+    //@{
+    static inline bool classof(const FlatDFPTData<Key,Data> *) {
+        return true;
+    }
+    static inline bool classof(const PTData<Key,Data>* ptd) {
+        return ptd->getPTDTY() == PTData<Key,Data>::FlatDFPTD;
+    }
+    //@}
+
+protected:
+    /// Union points-to into the IN/OUT sets. Nothing is created when the
+    /// source set is empty.
+    //@{
+    inline bool unionDFInFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return unionRowPts(dfInRows, dstLoc, dstVar, dfInRows, srcLoc, srcVar);
+    }
+    inline bool unionDFInFromOut(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return unionRowPts(dfInRows, dstLoc, dstVar, dfOutRows, srcLoc, srcVar);
+    }
+    inline bool unionDFOutFromIn(LocID srcLoc, const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        return unionRowPts(dfOutRows, dstLoc, dstVar, dfInRows, srcLoc, srcVar);
+    }
+    inline bool unionDFOutFromTLV(const Key& srcVar, LocID dstLoc, const Key& dstVar) {
+        const Data& srcPts = this->getPts(srcVar);
+        if (srcPts.empty())
+            return false;
+        return this->unionPts(getOrCreatePts(dfOutRows, dstLoc, dstVar), srcPts);
+    }
+    //@}
+
+    inline Data* getDFInPtsSetForUpdate(LocID loc, const Key& var) {
+        return &getOrCreatePts(dfInRows, loc, var);
+    }
+
+private:
+    /// Return the points-to set of var at loc, or NULL if there is none.
+    static inline const Data* findPts(const DFPtsRows& rows, LocID loc, const Key& var) {
+        if (loc >= rows.size())
+            return NULL;
+        const PtsRow& row = rows[loc];
+        typename KeyVector::const_iterator it = std::lower_bound(row.vars.begin(), row.vars.end(), var);
+        if (it == row.vars.end() || *it != var)
+            return NULL;
+        return &row.pts[it - row.vars.begin()];
+    }
+
+    /// Return the points-to set of var at loc, creating it if needed.
+    /// This may move other sets in the same row.
+    static inline Data& getOrCreatePts(DFPtsRows& rows, LocID loc, const Key& var) {
+        if (loc >= rows.size())
+            rows.resize(loc + 1);
+        PtsRow& row = rows[loc];
+        typename KeyVector::iterator it = std::lower_bound(row.vars.begin(), row.vars.end(), var);
+        size_t idx = it - row.vars.begin();
+        if (it == row.vars.end() || *it != var) {
+            row.vars.insert(it, var);
+            row.pts.insert(row.pts.begin() + idx, Data());
+        }
+        return row.pts[idx];
+    }
+
+    /// dstRows[dstLoc:dstVar] = dstRows[dstLoc:dstVar] U srcRows[srcLoc:srcVar]
+    inline bool unionRowPts(DFPtsRows& dstRows, LocID dstLoc, const Key& dstVar,
+                            const DFPtsRows& srcRows, LocID srcLoc, const Key& srcVar) {
+        const Data* srcPts = findPts(srcRows, srcLoc, srcVar);
+        if (srcPts == NULL || srcPts->empty())
+            return false;
+
+        Data& dstPts = getOrCreatePts(dstRows, dstLoc, dstVar);
+        /// Creating the destination may have moved the source set.
+        srcPts = findPts(srcRows, srcLoc, srcVar);
+        return this->unionPts(dstPts, *srcPts);
+    }
+
+    static inline u32_t getNumOfBrokenRows(const DFPtsRows& rows) {
+        u32_t numOfBroken = 0;
+        for (LocID loc = 0; loc < rows.size(); ++loc) {
+            const PtsRow& row = rows[loc];
+            bool broken = row.vars.size() != row.pts.size();
+            for (size_t i = 0; !broken && i < row.vars.size(); ++i) {
+                if ((i > 0 && !(row.vars[i - 1] < row.vars[i])) || findPts(rows, loc, row.vars[i]) != &row.pts[i])
+                    broken = true;
+            }
+            if (broken)
+                ++numOfBroken;
+        }
+        return numOfBroken;
+    }
+
+    static inline void getLocs(const DFPtsRows& rows, NodeBS& locs) {
+        for (LocID loc = 0; loc < rows.size(); ++loc) {
+            if (!rows[loc].vars.empty())
+                locs.set(loc);
+        }
+    }
+
+    static inline void getVars(const DFPtsRows& rows, LocID loc, NodeBS& vars) {
+        if (loc >= rows.size())
+            return;
+        const KeyVector& rowVars = rows[loc].vars;
+        for (typename KeyVector::const_iterator it = rowVars.begin(), eit = rowVars.end(); it != eit; ++it)
+            vars.set(*it);
+    }
+
+    DFPtsRows dfInRows;     ///< Data-flow IN set
+    DFPtsRows dfOutRows;    ///< Data-flow OUT set
+    Data emptyPts;          ///< Returned for missing sets
+};
+
 #endif /* POINTSTODSDF_H_ */
@@ -66,6 +66,8 @@ public:
         DFPTD,
         IncDFPTD,
         DiffPTD,
+        HCDFPTD,
+        FlatDFPTD,
         Default
     };
     /// Constructor
@@ -97,6 +99,12 @@ public:
         return ptsMap[var];
     }
 
+    /// Get the points-to set of the pointer without adding one, NULL if it has none
+    inline const Data* findPts(const Key& var) const {
+        PtsMapConstIter it = ptsMap.find(var);
+        return it == ptsMap.end() ? NULL : &it->second;
+    }
+
     // Get conditional reverse points-to set of the pointer
     inline Data& getRevPts(const Key& var) {
         return revPtsMap[var];
@@ -116,6 +124,12 @@ public:
         addRevPts(srcData,dstKey);
         return unionPts(getPts(dstKey),srcData);
     }
+    /// Add tgr to the reverse points-to of every target in ptsData, for
+    /// callers which union ptsData into the points-to of tgr themselves.
+    inline void addRevPts(const Data &ptsData, const Key& tgr) {
+        for(iterator it = ptsData.begin(), eit = ptsData.end(); it!=eit; ++it)
+            addSingleRevPts(getRevPts(*it),tgr);
+    }
 
 protected:
     PtsMap ptsMap;
@@ -133,10 +147,6 @@ private:
     inline void addSingleRevPts(Data &revData, const Key& tgr) {
         addPts(revData,tgr);
     }
-    inline void addRevPts(const Data &ptsData, const Key& tgr) {
-        for(iterator it = ptsData.begin(), eit = ptsData.end(); it!=eit; ++it)
-            addSingleRevPts(getRevPts(*it),tgr);
-    }
     //@}
 
     PTDataTY ptdTy;
@@ -198,11 +208,14 @@ public:
      * 2. update propagated pts: propa = all.
      */
     inline bool computeDiffPts(Key& var, Data& all) {
+        return computeDiffPts(getDiffPts(var), getPropaPts(var), all);
+    }
+
+    /// Same as above on the diff and propagated sets of a variable which
+    /// the caller has already looked up.
+    static inline bool computeDiffPts(Data& diff, Data& propa, const Data& all) {
         /// clear diff pts.
-        Data& diff = getDiffPts(var);
         diff.clear();
-        /// get all pts
-        Data& propa = getPropaPts(var);
         diff.intersectWithComplement(all, propa);
         propa = all;
         return (diff.empty() == false);
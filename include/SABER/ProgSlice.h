@@ -42,6 +42,8 @@ public:
     typedef SVFGNodeSet::iterator SVFGNodeSetIter;
     typedef PathCondAllocator::Condition Condition;
     typedef std::map<const SVFGNode*, Condition*> SVFGNodeToCondMap; 	///< map a SVFGNode to its condition during value-flow guard computation
+    typedef PathCondAllocator::CondVector CondVector;
+    typedef PathCondAllocator::CondScope CondScope;
 
     typedef FIFOWorkList<const SVFGNode*> VFWorkList;		    ///< worklist for value-flow guard computation
     typedef FIFOWorkList<const BasicBlock*> CFWorkList;	///< worklist for control-flow guard computation
@@ -178,7 +180,7 @@ private:
     void destroy();
     /// Clear Control flow conditions before each VF computation
     inline void clearCFCond() {
-        /// TODO: how to clean bdd memory
+        /// their BDDs are released with the conditions of the slice
         pathAllocator->clearCFCond();
     }
 
@@ -253,6 +255,7 @@ private:
     PathCondAllocator* pathAllocator;		///<  path condition allocator
     const SVFGNode* _curSVFGNode;			///<  current svfg node during guard computation
     Condition* finalCond;					///<  final condition
+    CondVector conds;						///<  conditions created for this slice, released with it
     const SVFG* svfg;						///<  SVFG
 };
 
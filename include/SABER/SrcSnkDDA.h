@@ -35,6 +35,7 @@
 #include "SABER/ProgSlice.h"
 #include "SABER/SaberSVFGBuilder.h"
 #include "WPA/Andersen.h"
+#include <mutex>
 
 typedef CFLSolver<SVFG*,CxtDPItem> CFLSrcSnkSolver;
 
@@ -50,8 +51,18 @@ public:
     typedef CxtDPItem DPIm;
     typedef std::set<DPIm> DPImSet;							///< dpitem set
     typedef std::map<const SVFGNode*, DPImSet> SVFGNodeToDPItemsMap; 	///< map a SVFGNode to its visited dpitems
+    typedef std::vector<DPIm> DPImVector;
 
 private:
+    /// Computes the slice of one source with its own worklist and visited
+    /// sets, so that slices can be computed on several threads
+    class SliceSolver;
+
+    /// What is reached in a callee from one of its entry nodes, computed
+    /// once and shared by all slices entering the callee there
+    struct CalleeSummary;
+    typedef std::map<const SVFGNode*, CalleeSummary*> CalleeSummaryMap;
+
     ProgSlice* _curSlice;		/// current program slice
     SVFGNodeSet sources;		/// source nodes
     SVFGNodeSet sinks;		/// source nodes
@@ -61,10 +72,18 @@ private:
     SaberSVFGBuilder memSSA;
     SVFG* svfg;
     PTACallGraph* ptaCallGraph;
+    CalleeSummaryMap calleeSummaries;	///< summaries of the callee entry nodes
+    std::mutex calleeSummaryMutex;	///< guards calleeSummaries when slices are computed in parallel
+    NodeBS summarisedEntries;	///< entry nodes whose summaries were applied to the current slice
+    bool traverseCallees;	///< traverse callees even with -saber-summary, to check the summaries
+    u32_t numOfSummaryChecks;	///< slices checked by -saber-check-summary
+    u32_t numOfSummaryDiffs;	///< checked slices reaching what the plain traversal does not
+    u32_t numOfSmallerSummarySlices;	///< checked slices smaller than with the plain traversal
 public:
 
     /// Constructor
-    SrcSnkDDA() : _curSlice(NULL), svfg(NULL), ptaCallGraph(NULL) {
+    SrcSnkDDA() : _curSlice(NULL), svfg(NULL), ptaCallGraph(NULL), traverseCallees(false),
+        numOfSummaryChecks(0), numOfSummaryDiffs(0), numOfSmallerSummarySlices(0) {
         pathCondAllocator = new PathCondAllocator();
     }
     /// Destructor
@@ -77,6 +96,8 @@ public:
             delete ptaCallGraph;
         ptaCallGraph = NULL;
 
+        releaseCalleeSummaries();
+
         //if(pathCondAllocator)
         //    delete pathCondAllocator;
         //pathCondAllocator = NULL;
@@ -102,6 +123,8 @@ public:
     /// Finalize analysis
     virtual void finalize() {
         dumpSlices();
+        validateSummaryTests();
+        getPathAllocator()->validateCondTests();
     }
 
     /// Get SVFG
@@ -187,25 +210,55 @@ public:
 protected:
     /// Forward traverse
     virtual inline void forwardProcess(const DPIm& item) {
-        const SVFGNode* node = getNode(item.getCurNodeID());
-        if(isSink(node)) {
-            addSinkToCurSlice(node);
-            _curSlice->setPartialReachable();
-        }
-        else
-            addToCurForwardSlice(node);
+        processForward(_curSlice, getNode(item.getCurNodeID()));
     }
     /// Backward traverse
     virtual inline void backwardProcess(const DPIm& item) {
-        const SVFGNode* node = getNode(item.getCurNodeID());
-        if(isInCurForwardSlice(node)) {
-            addToCurBackwardSlice(node);
-        }
+        processBackward(_curSlice, getNode(item.getCurNodeID()));
     }
     /// Propagate information forward by matching context
     virtual void forwardpropagate(const DPIm& item, SVFGEdge* edge);
     /// Propagate information backward without matching context, as forward analysis already did it
     virtual void backwardpropagate(const DPIm& item, SVFGEdge* edge);
+
+    /// Steps of the slice computation on a given slice and visited sets,
+    /// shared by the sequential and the parallel traversals. They only
+    /// read the analysis state.
+    //@{
+    void processForward(ProgSlice* slice, const SVFGNode* node);
+    void processBackward(ProgSlice* slice, const SVFGNode* node);
+    /// Whether newItem, reached through edge, is to be pushed into the worklist
+    bool propagateForward(ProgSlice* slice, SVFGNodeToDPItemsMap& visited, SVFGEdge* edge, DPIm& newItem);
+    /// Whether the source of edge is to be pushed into the worklist
+    bool propagateBackward(SVFGNodeSet& visited, SVFGEdge* edge);
+    /// Whether edge enters a callee whose summary is applied to the slice
+    /// instead of traversing the callee (-saber-summary). The items reached
+    /// back in the caller are then put into newItems.
+    bool propagateThroughCallee(ProgSlice* slice, SVFGNodeToDPItemsMap& visited, NodeBS& summarised,
+                                SVFGEdge* edge, const DPIm& item, DPImVector& newItems);
+    //@}
+
+    /// Callee summaries
+    //@{
+    const CalleeSummary* getCalleeSummary(const SVFGNode* entry, SVFGNodeSet& inProgress);
+    CalleeSummary* computeCalleeSummary(const SVFGNode* entry, SVFGNodeSet& inProgress);
+    void applyCalleeSummary(ProgSlice* slice, NodeBS& summarised, const CalleeSummary* summary);
+    void releaseCalleeSummaries();
+    //@}
+
+    /// Compute the slices of all sources on several threads, then check and
+    /// report them sequentially in the order of the sources
+    void analyzeInParallel();
+    /// Number of differences between slice and the slice of its source
+    /// computed by the sequential traversal (-saber-check-parallel)
+    u32_t getNumOfSliceDiffs(const ProgSlice* slice);
+    /// Compare slice, computed with callee summaries, with the slice of its
+    /// source computed by traversing callees (-saber-check-summary)
+    void checkSummarySlice(const ProgSlice* slice);
+    /// Report the checks of checkSummarySlice
+    void validateSummaryTests();
+    /// Compute the forward and backward slices of src as the current slice
+    void computeCurSlice(const SVFGNode* src);
     /// Whether has been visited or not, in order to avoid recursion on SVFG
     //@{
     inline bool forwardVisited(const SVFGNode* node, const DPIm& item) {
@@ -227,6 +280,7 @@ protected:
     inline void clearVisitedMap() {
         nodeToDPItemsMap.clear();
         visitedSet.clear();
+        summarisedEntries.clear();
     }
     //@}
 
@@ -80,7 +80,7 @@ typedef signed s32_t;
 typedef signed long Size_t;
 
 typedef llvm::SparseBitVector<> NodeBS;
-typedef NodeBS PointsTo;
+class PointsTo;
 typedef PointsTo AliasSet;
 
 template <typename T>
@@ -40,9 +40,10 @@
 class BddCondManager {
 public:
     typedef std::map<unsigned,DdNode*> IndexToDDNodeMap;
+    typedef std::vector<DdNode*> DdNodeVector;
 
     /// Constructor
-    BddCondManager() {
+    BddCondManager(): refScope(NULL) {
         m_bdd_mgr = Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
     }
 
@@ -66,6 +67,10 @@ public:
     inline unsigned BddVarNum() {
         return Cudd_ReadSize(m_bdd_mgr);
     }
+    /// Index of the next new BDD condition
+    inline unsigned getNextCondIndex() const {
+        return indexToDDNodeMap.size();
+    }
 
     inline DdNode* getTrueCond() const {
         return BddOne();
@@ -86,6 +91,36 @@ public:
     inline void markForRelease(DdNode* cond) {
         Cudd_RecursiveDeref(m_bdd_mgr,cond);
     }
+    /// Increase reference counting for the bdd, to be paired with markForRelease
+    inline void retain(DdNode* cond) {
+        Cudd_Ref(cond);
+    }
+
+    /// Conditions referenced by AND/OR while a scope is set are recorded in
+    /// it, to be released together by releaseScope.
+    //@{
+    inline DdNodeVector* setRefScope(DdNodeVector* scope) {
+        DdNodeVector* prev = refScope;
+        refScope = scope;
+        return prev;
+    }
+    void releaseScope(DdNodeVector& scope);
+    /// Whether the reference counts and unique table of the manager are consistent
+    inline bool isConsistent() {
+        return Cudd_DebugCheck(m_bdd_mgr) == 0;
+    }
+    //@}
+
+    /// Reclaim the nodes of released conditions, and reorder the variables
+    /// to shrink the BDDs of the live ones
+    //@{
+    inline void collectGarbage() {
+        cuddGarbageCollect(m_bdd_mgr, 1);
+    }
+    inline void reorder() {
+        Cudd_ReduceHeap(m_bdd_mgr, CUDD_REORDER_SIFT, 1);
+    }
+    //@}
     /// Operations on conditions.
     //@{
     DdNode* AND(DdNode* lhs, DdNode* rhs);
@@ -117,8 +152,15 @@ private:
         return Cudd_ReadLogicZero(m_bdd_mgr);
     }
 
+    /// Record a condition referenced by AND/OR in the current scope
+    inline void addToRefScope(DdNode* cond) {
+        if(refScope)
+            refScope->push_back(cond);
+    }
+
     DdManager *m_bdd_mgr;
     IndexToDDNodeMap indexToDDNodeMap;
+    DdNodeVector* refScope;	///< conditions referenced in the current scope
 };
 
 #endif /* BITVECTORCOND_H_ */
@@ -0,0 +1,89 @@
+//===- Parallel.h -- Running independent work items on several threads -------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * Parallel.h
+ *
+ * Helpers for the parallel solving modes. Work items handed to parallelFor
+ * must only write state no other item touches; results that have to be
+ * merged are best written to a slot per item and merged afterwards, in
+ * index order, so that results do not depend on scheduling.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include "Util/BasicTypes.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace SVFUtil {
+
+/// Number of threads parallel modes may use (-svf-threads).
+u32_t getNumOfThreads();
+
+/// Number of threads parallel modes which read or write points-to sets may
+/// use. Hash-consed points-to sets (PointsTo::HCS) share a global table which
+/// is not thread-safe, so with them this is always one.
+u32_t getNumOfPtsWorkers();
+
+/// Call fn(i) for each i in [begin, end) on up to numThreads threads (the
+/// calling thread included). Indices are handed out in chunks of grainSize;
+/// ranges of at most one chunk run on the calling thread only.
+template<typename Fn>
+void parallelFor(u32_t begin, u32_t end, Fn fn, u32_t numThreads = getNumOfThreads(), u32_t grainSize = 64) {
+    if (begin >= end)
+        return;
+
+    u32_t numChunks = (end - begin + grainSize - 1) / grainSize;
+    numThreads = std::min(numThreads, numChunks);
+    if (numThreads <= 1) {
+        for (u32_t i = begin; i < end; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<u32_t> next(begin);
+    auto worker = [&]() {
+        u32_t start;
+        while ((start = next.fetch_add(grainSize)) < end) {
+            u32_t stop = std::min(end, start + grainSize);
+            for (u32_t i = start; i < stop; ++i)
+                fn(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (u32_t t = 1; t < numThreads; ++t)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+} // End namespace SVFUtil
+
+#endif /* PARALLEL_H_ */
@@ -34,6 +34,7 @@
 #include "Util/Conditions.h"
 #include "Util/WorkList.h"
 #include "Util/DataFlowUtil.h"
+#include <tuple>
 
 /**
  * PathCondAllocator allocates conditions for each basic block of a certain CFG.
@@ -51,10 +52,31 @@ public:
     typedef std::map<const Function*,  BasicBlockSet> FunToExitBBsMap;  ///< map a function to all its basic blocks calling program exit
     typedef std::map<const BasicBlock*, Condition*> BBToCondMap;	///< map a basic block to its condition during control-flow guard computation
     typedef FIFOWorkList<const BasicBlock*> CFWorkList;	///< worklist for control-flow guard computation
-
-    /// Constructor
-    PathCondAllocator() {
-        getBddCondManager();
+    typedef BddCondManager::DdNodeVector CondVector;
+
+    /*!
+     * Conditions created by an allocator while a CondScope is alive are
+     * recorded in the scope's vector, to be released by releaseConds once
+     * their owner (e.g. a ProgSlice) is done with them.
+     */
+    class CondScope {
+    public:
+        CondScope(PathCondAllocator* pa, CondVector& scope): condMgr(pa->condMgr) {
+            prevScope = condMgr->setRefScope(&scope);
+        }
+        ~CondScope() {
+            condMgr->setRefScope(prevScope);
+        }
+    private:
+        BddCondManager* condMgr;
+        CondVector* prevScope;
+    };
+
+    /// Constructor. Conditions are allocated by the manager shared by all
+    /// allocators, or, with ownManager, by a manager of this allocator only,
+    /// e.g. to compute guards on several threads with an allocator each.
+    PathCondAllocator(bool ownManager = false): numOfReleases(0), numOfBadReleases(0), numOfGuardCacheHits(0), numOfGuardCacheMisses(0), numOfStaleGuards(0), ownsCondMgr(ownManager) {
+        condMgr = ownManager ? new BddCondManager() : getBddCondManager();
     }
     /// Destructor
     virtual ~PathCondAllocator() {
@@ -107,44 +129,47 @@ public:
     /// Condition operations
     //@{
     inline Condition* condAnd(Condition* lhs, Condition* rhs) {
-        return bddCondMgr->AND(lhs,rhs);
+        return condMgr->AND(lhs,rhs);
     }
     inline Condition* condOr(Condition* lhs, Condition* rhs) {
-        return bddCondMgr->OR(lhs,rhs);
+        return condMgr->OR(lhs,rhs);
     }
     inline Condition* condNeg(Condition* cond) {
-        return bddCondMgr->NEG(cond);
+        return condMgr->NEG(cond);
     }
     inline Condition* getTrueCond() const {
-        return bddCondMgr->getTrueCond();
+        return condMgr->getTrueCond();
     }
     inline Condition* getFalseCond() const {
-        return bddCondMgr->getFalseCond();
+        return condMgr->getFalseCond();
     }
     /// Given an index, get its condition
     inline Condition* getCond(u32_t i) const {
-        return bddCondMgr->getCond(i);
+        return condMgr->getCond(i);
     }
     /// Iterator every element of the bdd
     inline NodeBS exactCondElem(Condition* cond) {
         NodeBS elems;
-        bddCondMgr->BddSupport(cond,elems);
+        condMgr->BddSupport(cond,elems);
         return elems;
     }
     /// Decrease reference counting for the bdd
     inline void markForRelease(Condition* cond) {
-        bddCondMgr->markForRelease(cond);
+        condMgr->markForRelease(cond);
     }
+    /// Release the conditions recorded by a CondScope
+    void releaseConds(CondVector& conds);
     /// Print debug information for this condition
     inline void printDbg(Condition* cond) {
-        bddCondMgr->printDbg(cond);
+        condMgr->printDbg(cond);
     }
     inline std::string dumpCond(Condition* cond) const {
-        return bddCondMgr->dumpStr(cond);
+        return condMgr->dumpStr(cond);
     }
     //@}
 
     /// Guard Computation for a value-flow (between two basic blocks)
+    /// Guards computed right after clearCFCond are memoised (see getGuard)
     //@{
     virtual Condition* ComputeIntraVFGGuard(const BasicBlock* src, const BasicBlock* dst);
     virtual Condition* ComputeInterCallVFGGuard(const BasicBlock* src, const BasicBlock* dst, const BasicBlock* callBB);
@@ -170,7 +195,39 @@ public:
     /// Print out the path condition information
     void printPathCond();
 
+    /// Report the checks of the conditions enabled by options (e.g. -bdd-check-release)
+    void validateCondTests();
+
+    /// Guard cache statistics
+    //@{
+    inline u32_t getNumOfGuardCacheHits() const {
+        return numOfGuardCacheHits;
+    }
+    inline u32_t getNumOfGuardCacheMisses() const {
+        return numOfGuardCacheMisses;
+    }
+    //@}
+
 private:
+    /// Kinds of guards memoised in guardCache
+    enum GuardKind {
+        IntraGuard,
+        InterCallGuard,
+        InterRetGuard
+    };
+    /// (kind, src bb, dst bb, call/ret bb, value evaluated by branch conditions)
+    typedef std::tuple<GuardKind, const BasicBlock*, const BasicBlock*, const BasicBlock*, const Value*> GuardKey;
+    typedef std::map<GuardKey, Condition*> GuardCache;
+
+    /// Return the guard of the given kind, from guardCache if it was computed before
+    Condition* getGuard(GuardKind kind, const BasicBlock* src, const BasicBlock* dst, const BasicBlock* callRetBB);
+
+    /// Guard computation on the current control-flow conditions
+    //@{
+    Condition* computeIntraGuard(const BasicBlock* src, const BasicBlock* dst);
+    Condition* computeInterCallGuard(const BasicBlock* src, const BasicBlock* dst, const BasicBlock* callBB);
+    Condition* computeInterRetGuard(const BasicBlock* src, const BasicBlock* dst, const BasicBlock* retBB);
+    //@}
 
     /// Allocate path condition for every basic block
     virtual void allocateForBB(const BasicBlock& bb);
@@ -240,7 +297,8 @@ private:
 
     /// Allocate a new condition
     inline Condition* newCond(const Instruction* inst) {
-        Condition* cond = bddCondMgr->createNewCond(totalCondNum++);
+        Condition* cond = condMgr->createNewCond(condMgr->getNextCondIndex());
+        totalCondNum++;
         assert(condToInstMap.find(cond)==condToInstMap.end() && "this should be a fresh condition");
         condToInstMap[cond] = inst;
         return cond;
@@ -261,8 +319,17 @@ private:
     BBToCondMap bbToCondMap;				///< map a basic block to its path condition starting from root
     const Value* curEvalVal;			///< current llvm value to evaluate branch condition when computing guards
 
+    u32_t numOfReleases;					///< number of releaseConds calls
+    u32_t numOfBadReleases;				///< releaseConds calls leaving the manager inconsistent
+    GuardCache guardCache;					///< guards computed so far, referenced until destroy
+    u32_t numOfGuardCacheHits;
+    u32_t numOfGuardCacheMisses;
+    u32_t numOfStaleGuards;				///< cache hits differing from the recomputed guard
+
 protected:
-    static BddCondManager* bddCondMgr;		///< bbd manager
+    static BddCondManager* bddCondMgr;		///< bbd manager shared by allocators
+    BddCondManager* condMgr;				///< bbd manager of this allocator
+    bool ownsCondMgr;						///< whether condMgr is owned rather than shared
     BBCondMap bbConds;						///< map basic block to its successors/predecessors branch conditions
 
 };
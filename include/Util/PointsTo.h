@@ -0,0 +1,266 @@
+//===- PointsTo.h -- Points-to set with selectable representation ------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * PointsTo.h
+ *
+ * A points-to set whose underlying representation is chosen at runtime
+ * (PointsTo::setDefaultType) rather than being fixed by a typedef. The
+ * interface mirrors the parts of llvm::SparseBitVector used by SVF.
+ *
+ * Representations:
+ *  SBV: sparse bit vector (llvm::SparseBitVector, the old behaviour).
+ *  BV:  dense bit vector (llvm::BitVector), best for dense object IDs.
+ *  SV:  sorted small vector, best for the many tiny sets.
+ *  HCS: hash-consed, immutable sparse bit vectors. Equal sets share storage
+ *       and unions are memoised. Element updates (set, reset, |= NodeBS)
+ *       go to a private copy which is interned when the set is next
+ *       compared, unioned, copied or iterated. The table of interned sets
+ *       is freed once no HCS set is left. It is not synchronised: HCS sets
+ *       must only be used from one thread at a time, which is asserted.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SVF_POINTSTO_H_
+#define SVF_POINTSTO_H_
+
+#include "Util/BasicTypes.h"
+#include <llvm/ADT/BitVector.h>
+
+class PointsTo {
+public:
+    /// Underlying representation of a points-to set.
+    enum Type {
+        SBV,    ///< Sparse bit vector.
+        BV,     ///< Dense bit vector.
+        SV,     ///< Sorted small vector.
+        HCS,    ///< Hash-consed sparse bit vector.
+    };
+
+    class PointsToIterator;
+    typedef PointsToIterator iterator;
+    typedef PointsToIterator const_iterator;
+
+    typedef llvm::BitVector DenseBV;
+    typedef llvm::SmallVector<NodeID, 4> SortedVector;
+
+    /// Construct an empty set of the default type.
+    PointsTo(void);
+    /// Construct an empty set of type.
+    explicit PointsTo(Type type);
+    /// Copy the elements (and type) of pt.
+    PointsTo(const PointsTo &pt);
+    PointsTo(PointsTo &&pt);
+    /// Build from a NodeBS.
+    explicit PointsTo(const NodeBS &nbs);
+
+    ~PointsTo(void);
+
+    PointsTo &operator=(const PointsTo &rhs);
+    PointsTo &operator=(PointsTo &&rhs);
+
+    /// Representation used by newly constructed points-to sets.
+    //@{
+    static inline Type getDefaultType(void) {
+        return defaultType;
+    }
+    static inline void setDefaultType(Type type) {
+        defaultType = type;
+    }
+    //@}
+
+    /// Returns the representation of this set.
+    inline Type getType(void) const {
+        return type;
+    }
+
+    /// Returns true if set is empty.
+    bool empty(void) const;
+
+    /// Returns number of elements.
+    u32_t count(void) const;
+
+    /// Empty the set.
+    void clear(void);
+
+    /// Returns true if n is in this set.
+    bool test(NodeID n) const;
+
+    /// If n is not in this, adds it and returns true. Otherwise returns
+    /// false. Same as SparseBitVector::test_and_set.
+    bool test_and_set(NodeID n);
+
+    /// Adds n to the set.
+    void set(NodeID n);
+
+    /// Removes n from the set.
+    void reset(NodeID n);
+
+    /// Returns the smallest element, or -1 if the set is empty.
+    int find_first(void) const;
+
+    /// Returns true if this set is a superset of rhs.
+    bool contains(const PointsTo &rhs) const;
+
+    /// Returns true if this set and rhs share any elements.
+    bool intersects(const PointsTo &rhs) const;
+
+    /// Returns true if this set and rhs contain exactly the same elements.
+    bool operator==(const PointsTo &rhs) const;
+    inline bool operator!=(const PointsTo &rhs) const {
+        return !(*this == rhs);
+    }
+
+    /// Put union of this set and rhs into this set. Returns true if this set changed.
+    //@{
+    bool operator|=(const PointsTo &rhs);
+    bool operator|=(const NodeBS &rhs);
+    //@}
+
+    /// Put intersection of this set and rhs into this set. Returns true if this set changed.
+    bool operator&=(const PointsTo &rhs);
+
+    /// Put this - rhs into this set. Returns true if this set changed.
+    bool intersectWithComplement(const PointsTo &rhs);
+
+    /// Put lhs - rhs into this set.
+    void intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs);
+
+    /// Returns this - rhs.
+    PointsTo operator-(const PointsTo &rhs) const;
+
+    /// Returns this points-to set as a NodeBS.
+    NodeBS toNodeBS(void) const;
+    inline explicit operator NodeBS(void) const {
+        return toNodeBS();
+    }
+
+    iterator begin(void) const;
+    iterator end(void) const;
+
+    /// Hash-consing statistics.
+    //@{
+    static u32_t numHashConsedSets(void);
+    static u32_t numHashConsedUnionHits(void);
+    //@}
+
+private:
+    /// Constructs the empty representation of type t in the union.
+    void initialise(Type t);
+    /// Destroys the representation currently held.
+    void destroy(void);
+    /// Copies rhs's representation into this (assumed destroyed).
+    void copyFrom(const PointsTo &rhs);
+    /// Convert this set to type t, keeping its elements.
+    void convert(Type t);
+
+    /// Hash-consing helpers.
+    //@{
+    /// Returns the elements of an HCS set, interned or not.
+    inline const NodeBS &hashConsedElems(void) const {
+        return hc.pending != NULL ? *hc.pending : *hc.set;
+    }
+    /// Interns the pending updates of an HCS set and returns its canonical set.
+    const NodeBS *canonical(void) const;
+    /// Returns the private copy element updates of an HCS set go to.
+    NodeBS &pendingElems(void);
+    /// Returns the canonical copy of nbs.
+    static const NodeBS *hashCons(const NodeBS &nbs);
+    /// Returns the canonical empty set.
+    static const NodeBS *emptyHashConsed(void);
+    /// Returns the (memoised) canonical union of lhs and rhs.
+    static const NodeBS *hashConsedUnion(const NodeBS *lhs, const NodeBS *rhs);
+    /// Count live HCS sets; the interned sets are freed with the last one.
+    static void retainHashConsed(void);
+    static void releaseHashConsed(void);
+    //@}
+
+    /// An HCS set: its canonical set, and its updates not interned yet.
+    struct HashConsed {
+        const NodeBS *set;
+        NodeBS *pending;
+    };
+
+private:
+    /// Type of newly constructed sets.
+    static Type defaultType;
+
+    /// Type of this set.
+    Type type;
+    union {
+        NodeBS sbv;
+        DenseBV bv;
+        SortedVector sv;
+        mutable HashConsed hc;
+    };
+
+public:
+    class PointsToIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef NodeID value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const NodeID *pointer;
+        typedef const NodeID &reference;
+
+        /// Returns an iterator to the beginning of pt if end is false, and to
+        /// the end of pt if end is true.
+        PointsToIterator(const PointsTo *pt, bool end = false);
+        PointsToIterator(const PointsToIterator &pt);
+        ~PointsToIterator(void);
+
+        PointsToIterator &operator=(const PointsToIterator &rhs);
+
+        /// Pre-increment: ++it.
+        PointsToIterator &operator++(void);
+        /// Post-increment: it++.
+        PointsToIterator operator++(int);
+
+        /// Dereference: *it.
+        NodeID operator*(void) const;
+
+        bool operator==(const PointsToIterator &rhs) const;
+        inline bool operator!=(const PointsToIterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        void destroy(void);
+        void copyFrom(const PointsToIterator &rhs);
+
+        Type type;
+        union {
+            /// SBV and HCS.
+            NodeBS::iterator sbvIt;
+            /// BV: position in the bit vector; -1 at the end.
+            struct {
+                const DenseBV *bv;
+                int idx;
+            } bvIt;
+            /// SV.
+            const NodeID *svIt;
+        };
+    };
+};
+
+#endif  // SVF_POINTSTO_H_
@@ -34,6 +34,7 @@
 #include "Util/ExtAPI.h"
 #include "Util/ThreadAPI.h"
 #include "Util/BasicTypes.h"
+#include "Util/PointsTo.h"
 #include <time.h>
 
 /*
@@ -466,7 +467,9 @@ inline bool ArgInNoCallerFunction (const Value * val) {
 //@}
 
 /// Return true if the function has a return instruction reachable from function entry
-bool functionDoesNotRet (const Function * fun);
+/// A function which is not the program entry and has none is reported by writeWrnMsg,
+/// unless warn is false
+bool functionDoesNotRet (const Function * fun, bool warn = true);
 
 /// Get reachable basic block from function entry
 void getFunReachableBBs (const Function * fun, DominatorTree* dt,std::vector<const BasicBlock*>& bbs);
@@ -580,6 +583,9 @@ std::string  getSourceLocOfFunction(const Function *F);
 /// Dump sparse bitvector set
 void dumpSet(NodeBS To, raw_ostream & O = SVFUtil::outs());
 
+/// Dump points-to set elements
+void dumpSet(const PointsTo& To, raw_ostream & O = SVFUtil::outs());
+
 /// Dump points-to set
 void dumpPointsToSet(unsigned node, NodeBS To) ;
 
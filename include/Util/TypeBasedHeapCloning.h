@@ -126,6 +126,10 @@ protected:
     /// %n+n after filtering with !t1 and !t2 respectively.
     void validateTBHCTests(SVFModule &svfMod);
 
+    /// Checks the lookup caches (objToGepsAtOffset, objToTypedClone,
+    /// gepToTypedClone, locToKeptSet) against the scans they replace.
+    void validateLookupCacheTests(void);
+
     /// Dump some statistics we tracked.
     void dumpStats(void);
 
@@ -151,6 +155,18 @@ private:
     DenseMap<NodeID, NodeBS> objToGeps;
     /// Maps memory objects to their GEP objects. (memobj -> (fieldidx -> geps))
     DenseMap<const MemObj *, DenseMap<unsigned, NodeBS>> memObjToGeps;
+    /// Index of objToGeps by the offset of the GEP objects. (base -> (offset -> geps))
+    DenseMap<NodeID, DenseMap<unsigned, NodeBS>> objToGepsAtOffset;
+    /// FI/dummy object -> type -> first clone of that type (o -> (t -> clone)).
+    DenseMap<NodeID, DenseMap<const DIType *, NodeID>> objToTypedClone;
+    /// GEP object, as (base, offset) -> type -> GEP object of that type cloneObject
+    /// found or cloned for it. Only the first lookup of a type goes through getGepObjClones.
+    DenseMap<std::pair<NodeID, unsigned>, DenseMap<const DIType *, NodeID>> gepToTypedClone;
+    /// Values -> canonical type of their ctir metadata (nullptr if none).
+    DenseMap<const Value *, const DIType *> valueToCTirType;
+    /// Maps locations to the objects init kept unchanged there. init makes
+    /// the same decision for them on every visit, so they are not re-examined.
+    DenseMap<NodeID, PointsTo> locToKeptSet;
 
     /// Test whether object is a GEP object. For convenience.
     bool isGep(const PAGNode *n) const;
@@ -170,5 +186,14 @@ private:
     unsigned numSGTBSU  = 0;
     unsigned numSGReuse = 0;
     unsigned numSGAgg   = 0;
+
+    // Lookup cache hits/misses (GEP: gepToTypedClone, clone: objToTypedClone,
+    // filter: locToKeptSet).
+    unsigned numGepCacheHits      = 0;
+    unsigned numGepCacheMisses    = 0;
+    unsigned numCloneCacheHits    = 0;
+    unsigned numCloneCacheMisses  = 0;
+    unsigned numFilterCacheHits   = 0;
+    unsigned numFilterCacheMisses = 0;
 };
 
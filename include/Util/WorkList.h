@@ -41,6 +41,9 @@
 #include <vector>
 #include <deque>
 #include <set>
+#include <queue>
+#include <limits>
+#include <functional>
 
 /**
  * Worklist with "first come first go" order.
@@ -234,4 +237,162 @@ private:
 
 
 
+/**
+ * Worklist of dense unsigned IDs (e.g. NodeID) whose order is chosen at runtime.
+ * Membership is a bit vector indexed by ID instead of a std::set.
+ *  FIFO:     first in first out.
+ *  LRF:      least recently fired first: the ID popped least recently (or
+ *            never) goes first.
+ *  TOPO:     lowest priority first, e.g. the topological order of the graph.
+ *  TWOPHASE: IDs pushed while the current phase runs wait for the next one;
+ *            each phase pops its IDs by priority, like TOPO.
+ * IDs are unique in the list. IDs with no priority go after all the others.
+ */
+template<class Data>
+class NodeWorkList {
+public:
+    enum Strategy {
+        FIFO,
+        LRF,
+        TOPO,
+        TWOPHASE
+    };
+
+    NodeWorkList(Strategy s = FIFO) : strategy(s), numOfData(0), numOfPops(0) {}
+
+    ~NodeWorkList() {}
+
+    /// Get/set the order; only an empty list can change its order
+    //@{
+    inline Strategy getStrategy() const {
+        return strategy;
+    }
+    inline void setStrategy(Strategy s) {
+        assert(empty() && "changing the order of a non-empty work list");
+        strategy = s;
+    }
+    //@}
+
+    /// Set the priority of id, used by TOPO and TWOPHASE. Only affects later
+    /// pushes, until reprioritise is called.
+    inline void setPriority(Data id, unsigned priority) {
+        if (id >= priorities.size())
+            priorities.resize(id + 1, std::numeric_limits<unsigned>::max());
+        priorities[id] = priority;
+    }
+    /// Priority of id, the largest one if it has none
+    inline unsigned getPriority(Data id) const {
+        return id < priorities.size() ? priorities[id] : std::numeric_limits<unsigned>::max();
+    }
+
+    /// Re-order the ids in the list of TOPO (and the current phase of
+    /// TWOPHASE) by their current priorities
+    inline void reprioritise() {
+        if (strategy != TOPO && strategy != TWOPHASE)
+            return;
+        std::vector<Entry> entries;
+        entries.reserve(heap.size());
+        for (; !heap.empty(); heap.pop())
+            entries.push_back(Entry(getPriority(heap.top().second), heap.top().second));
+        heap = EntryHeap(std::greater<Entry>(), std::move(entries));
+    }
+
+    inline bool empty() const {
+        return numOfData == 0;
+    }
+
+    inline bool find(Data id) const {
+        return id < inList.size() && inList[id];
+    }
+
+    /**
+     * Push an id into the work list.
+     */
+    inline bool push(Data id) {
+        if (find(id))
+            return false;
+
+        if (id >= inList.size())
+            inList.resize(id + 1, false);
+        inList[id] = true;
+        numOfData++;
+
+        switch (strategy) {
+        case FIFO:
+            fifo.push_back(id);
+            break;
+        case LRF:
+            heap.push(Entry(id < lastFired.size() ? lastFired[id] : 0, id));
+            break;
+        case TOPO:
+            heap.push(Entry(getPriority(id), id));
+            break;
+        case TWOPHASE:
+            next.push_back(id);
+            break;
+        }
+        return true;
+    }
+
+    /**
+     * Pop an id according to the order of the work list.
+     */
+    inline Data pop() {
+        assert(!empty() && "work list is empty");
+        Data id;
+        if (strategy == FIFO) {
+            id = fifo.front();
+            fifo.pop_front();
+        }
+        else {
+            if (strategy == TWOPHASE && heap.empty()) {
+                /// Start the next phase.
+                for (typename DataVector::const_iterator it = next.begin(), eit = next.end(); it != eit; ++it)
+                    heap.push(Entry(getPriority(*it), *it));
+                next.clear();
+            }
+            id = heap.top().second;
+            heap.pop();
+        }
+
+        inList[id] = false;
+        numOfData--;
+        numOfPops++;
+        if (strategy == LRF) {
+            if (id >= lastFired.size())
+                lastFired.resize(id + 1, 0);
+            lastFired[id] = numOfPops;
+        }
+        return id;
+    }
+
+    /*!
+     * Clear all the data
+     */
+    inline void clear() {
+        inList.clear();
+        fifo.clear();
+        heap = EntryHeap();
+        next.clear();
+        numOfData = 0;
+    }
+
+private:
+    /// (key, id): the entry with the smallest key is popped first, ties by id
+    typedef std::pair<size_t, Data> Entry;
+    typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > EntryHeap;
+    typedef std::vector<Data> DataVector;
+
+    Strategy strategy;
+    std::vector<bool> inList;	///< whether an id is in the work list.
+    std::deque<Data> fifo;	///< FIFO order.
+    EntryHeap heap;	///< LRF and TOPO order, and the current phase of TWOPHASE.
+    DataVector next;	///< next phase of TWOPHASE.
+    std::vector<unsigned> priorities;	///< priority of each id.
+    std::vector<size_t> lastFired;	///< pop count when each id was last popped.
+    size_t numOfData;	///< number of ids in the work list.
+    size_t numOfPops;	///< number of pops so far.
+};
+
+
 #endif /* WORKLIST_H_ */
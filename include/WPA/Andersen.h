@@ -36,6 +36,7 @@
 #include "MemoryModel/PAG.h"
 #include "MemoryModel/ConsG.h"
 #include "MemoryModel/OfflineConsG.h"
+#include <llvm/ADT/BitVector.h>
 
 class PTAType;
 class SVFModule;
@@ -95,17 +96,19 @@ public:
     virtual void initialize(SVFModule svfModule);
     //}
 
+    /// File in -ander-cache-dir caching the results of this analysis on
+    /// svfModule, or "" if no cache directory is set. Must be called after
+    /// the PAG is built.
+    std::string getResultsCacheFile(SVFModule svfModule);
+
+    /// Check the results cached in cacheFile are the solved ones (-ander-check-cache)
+    void validateCacheTests(const std::string& cacheFile);
+
     /// Finalize analysis
-    virtual inline void finalize() {
-        /// dump constraint graph if PAGDotGraph flag is enabled
-        consCG->dump("consCG_final");
-        consCG->print();
-        /// sanitize field insensitive obj
-        /// TODO: Fields has been collapsed during Andersen::collapseField().
-        //	sanitizePts();
+    virtual void finalize();
 
-        PointerAnalysis::finalize();
-    }
+    /// Check that the solved points-to sets are a fixpoint (-ander-check-fixpoint)
+    void validateFixpointTests();
 
     /// Reset data
     inline void resetData() {
@@ -127,6 +130,7 @@ public:
                 || pta->getAnalysisTy() == AndersenHLCD_WPA
                 || pta->getAnalysisTy() == AndersenWaveDiff_WPA
                 || pta->getAnalysisTy() == AndersenWaveDiffWithType_WPA
+                || pta->getAnalysisTy() == AndersenWaveDiffParallel_WPA
                 || pta->getAnalysisTy() == AndersenSCD_WPA
                 || pta->getAnalysisTy() == AndersenSFR_WPA);
     }
@@ -146,6 +150,16 @@ public:
     virtual inline PointsTo& getPts(NodeID id) {
         return getPTDataTy()->getPts(sccRepNode(id));
     }
+    virtual inline const PointsTo* findPts(NodeID id) const {
+        return getPTDataTy()->findPts(sccRepNode(id));
+    }
+    /// The members of an SCC share the points-to set of its rep
+    virtual inline void getNodesSharingPts(NodeID id, NodeBS& nodes) {
+        if (sccRepNode(id) == id)
+            nodes |= sccSubNodes(id);
+        else
+            nodes.set(id);
+    }
     virtual inline bool unionPts(NodeID id, const PointsTo& target) {
         id = sccRepNode(id);
         return getPTDataTy()->unionPts(id, target);
@@ -212,7 +226,11 @@ protected:
         }
     }
 
-    virtual void initWorklist() {}
+    /// Prioritise nodes by topological order for the TOPO and TWOPHASE worklists
+    //@{
+    virtual void initWorklist();
+    virtual void updateTopoPriorities();
+    //@}
 
     virtual void setSCCEdgeFlag(ConstraintNode::SCCEdgeFlag f) {
         ConstraintNode::sccEdgeFlag = f;
@@ -284,6 +302,21 @@ protected:
     /// SCC detection
     virtual NodeStack& SCCDetect();
 
+    /// Incremental solving from the results of a previous run on an edited module
+    //@{
+    typedef DenseMap<const Instruction*, u32_t> InstIndexMap;
+    /// Key identifying node in the PAGs built from different versions of the
+    /// module, or "" if it has none
+    std::string getStableNodeKey(const PAGNode* node, InstIndexMap& instIndices) const;
+    /// Store the node keys and the dependences between points-to sets
+    void writeDependencesToFile(const std::string& filename);
+    /// Seed the points-to sets with the results stored in filename which do
+    /// not depend on the functions in changedFuns
+    bool readUnaffectedResults(const std::string& filename, const std::set<std::string>& changedFuns);
+    /// Check the seeded results are the ones of solving from scratch (-ander-check-incremental)
+    void validateIncrementalTests(SVFModule svfModule);
+    //@}
+
     /// Constraint Graph
     ConstraintGraph* consCG;
 
@@ -292,12 +325,12 @@ protected:
         for(ConstraintGraph::iterator it = consCG->begin(), eit = consCG->end(); it!=eit; ++it) {
             PointsTo& pts = getPts(it->first);
             NodeBS fldInsenObjs;
-            for(NodeBS::iterator pit = pts.begin(), epit = pts.end(); pit!=epit; ++pit) {
+            for(PointsTo::iterator pit = pts.begin(), epit = pts.end(); pit!=epit; ++pit) {
                 if(consCG->isFieldInsensitiveObj(*pit))
                     fldInsenObjs.set(*pit);
             }
             for(NodeBS::iterator pit = fldInsenObjs.begin(), epit = fldInsenObjs.end(); pit!=epit; ++pit) {
-                unionPts(it->first,consCG->getAllFieldsObjNode(*pit));
+                unionPts(it->first,PointsTo(consCG->getAllFieldsObjNode(*pit)));
             }
         }
     }
@@ -347,6 +380,8 @@ public:
     }
 
     virtual void solveWorklist();
+    virtual void processNodeStack(NodeStack& nodeStack);
+    virtual void postProcessWorklist();
     virtual void processNode(NodeID nodeId);
     virtual void postProcessNode(NodeID nodeId);
     virtual void handleCopyGep(ConstraintNode* node);
@@ -358,6 +393,10 @@ public:
 protected:
     virtual void mergeNodeToRep(NodeID nodeId,NodeID newRepId);
 
+    /// Every round of solveWorklist starts by an SCC detection over the whole
+    /// graph, which refreshes the priorities
+    virtual void updateTopoPriorities() {}
+
     virtual inline bool addCopyEdge(NodeID src, NodeID dst) {
         if (Andersen::addCopyEdge(src, dst)) {
             if (unionPts(sccRepNode(dst), sccRepNode(src)))
@@ -376,6 +415,43 @@ protected:
 };
 
 
+/*!
+ * Diff wave propagation where each wave is propagated in parallel.
+ * A wave is a topological level of the SCC-collapsed constraint graph, so no
+ * node of a wave reaches another through copy edges. Diff points-to of a wave
+ * are computed in parallel, then copy edges are processed in parallel grouped
+ * by destination. Gep edges (which may create field objects) and the graph
+ * updates are done sequentially between waves. Likewise, copy edges
+ * introduced by loads/stores are collected in parallel and inserted as a batch.
+ */
+class AndersenWaveDiffParallel : public AndersenWaveDiff {
+
+public:
+    typedef std::vector<NodeVector> Waves;
+
+    AndersenWaveDiffParallel(PTATY type = AndersenWaveDiffParallel_WPA): AndersenWaveDiff(type) {}
+
+    virtual void processNodeStack(NodeStack& nodeStack);
+    virtual void postProcessWorklist();
+
+protected:
+    /// Split nodeStack (in topological order) into waves
+    void computeWaves(NodeStack& nodeStack, Waves& waves);
+    /// Propagate the diff points-to of the nodes of one wave
+    void processWave(const NodeVector& wave);
+    /// Handle loads/stores of nodes, adding the new copy edges as a batch
+    void processLoadsAndStores(const NodeVector& nodes);
+    /// Record the objects of pts which loads/stores skip into skippedObjs
+    void markSkippedObjs(const PointsTo& pts);
+
+private:
+    /// Objects already checked by markSkippedObjs, and those of them which
+    /// are constant or non-pointer objects, indexed by object ID
+    llvm::BitVector checkedObjs;
+    llvm::BitVector skippedObjs;
+};
+
+
 
 /**
  * Wave propagation with diff points-to set with type filter.
@@ -46,9 +46,6 @@ private:
     typedef SVFG::SVFGEdgeSetTy SVFGEdgeSetTy;
 
 public:
-    typedef BVDataPTAImpl::IncDFPTDataTy::DFPtsMap DFInOutMap;
-    typedef BVDataPTAImpl::IncDFPTDataTy::PtsMap PtsMap;
-
     /// Constructor
     FlowSensitive(PTATY type = FSSPARSE_WPA) : WPASVFGFSSolver(), BVDataPTAImpl(type)
     {
@@ -131,6 +128,8 @@ protected:
 
     /// Propagation
     //@{
+    /// Propagate points-to information along the out edges of a node.
+    virtual void propagate(SVFGNode** v);
     /// Propagate points-to information from an edge's src node to its dst node.
     virtual bool propFromSrcToDst(SVFGEdge* edge);
     /// Propagate points-to information along a DIRECT SVFG edge.
@@ -192,6 +191,9 @@ protected:
     }
     //@}
 
+    /// Solve the worklist, in rounds if -fs-parallel-in-union is set
+    virtual void solveWorklist();
+
     /// Handle various constraints
     //@{
     virtual void processNode(NodeID nodeId);
@@ -217,6 +219,9 @@ protected:
     /// Return TRUE if this is a strong update STORE statement.
     bool isStrongUpdate(const SVFGNode* node, NodeID& singleton);
 
+    /// Check that the solved points-to sets are a fixpoint (-fs-check-fixpoint)
+    void validateFixpointTests();
+
     SVFG* svfg;
     SVFGBuilder memSSA;
     ///Get points-to set for a node from data flow IN/OUT set at a statement.
@@ -229,20 +234,21 @@ protected:
     }
     //@}
 
+    /// Collects the <location, pointer> pairs of the loads, stores, and GEPs
+    /// with ctir metadata, evaluated by printCTirAliasStats.
+    void collectCTirAliasLocs(std::set<std::pair<NodeID, NodeID>> &cmpLocs);
+
     /// Fills may/noAliases for the location/pointer pairs in cmp.
     virtual void countAliases(std::set<std::pair<NodeID, NodeID>> cmp, unsigned *mayAliases, unsigned *noAliases);
+    /// Adds to may/noAliases the results of alias over all ordered pairs of
+    /// distinct entries, where ptsList[i] is the points-to set of weights[i] entries.
+    void countAliases(const std::vector<const PointsTo *> &ptsList, const std::vector<u64_t> &weights,
+                      unsigned *mayAliases, unsigned *noAliases);
+    /// Check counts given by countAliases against alias on every pair (-ctir-check-alias-eval)
+    void validateAliasCountTests(const std::vector<const PointsTo *> &ptsList, const std::vector<u64_t> &weights,
+                                 u64_t numOfMay, u64_t numOfNo);
 
 private:
-    ///Get IN/OUT data flow map;
-    //@{
-    inline const DFInOutMap& getDFInputMap() const {
-        return getDFPTDataTy()->getDFIn();
-    }
-    inline const DFInOutMap& getDFOutputMap() const {
-        return getDFPTDataTy()->getDFOut();
-    }
-    //@}
-
     static FlowSensitive* fspta;
 
 protected:
@@ -79,9 +79,32 @@ public:
     /// If no ctir type exists, returns null (void).
     const DIType *getTypeFromCTirMetadata(const SVFGNode *);
 
+    /// Demand-driven mode: only the SVFG nodes which can influence the queried
+    /// locations/pointers (their backward slice) are solved. Queries must be
+    /// registered before analyze. Without queries, the ctir loads, stores, and
+    /// GEPs (those evaluated by -ctir-alias-eval) are queried.
+    //@{
+    inline void setDemandDriven(bool d) {
+        demandDriven = d;
+    }
+    /// Queries the points-to set of SVFG node loc (e.g. the pointer of a load).
+    inline void addQueryLocation(NodeID loc) {
+        queryLocs.set(loc);
+    }
+    /// Queries the points-to set of the top-level PAG node ptr.
+    inline void addQueryPointer(NodeID ptr) {
+        queryPtrs.set(ptr);
+    }
+    //@}
+
 protected:
     virtual void backPropagate(NodeID clone) override;
 
+    /// Computes the slice to solve first when demand-driven.
+    virtual void solve() override;
+    /// Nodes outside the slice are never pushed when demand-driven.
+    virtual void pushIntoWorklist(NodeID id) override;
+
     virtual void countAliases(std::set<std::pair<NodeID, NodeID>> cmp, unsigned *mayAliases, unsigned *noAliases) override;
 
 private:
@@ -93,6 +116,16 @@ private:
     /// is not for a GEP SVFG node, returns false.
     bool gepIsLoad(NodeID gep);
 
+    /// Computes slice: the SVFG nodes backward reachable from the queries and
+    /// from the function pointers of indirect callsites (the call graph has to
+    /// be resolved for the queries to be sound).
+    void computeSlice(void);
+
+    /// Checks the slice solved when demand-driven is closed under SVFG
+    /// in-edges of the final graph, so nodes outside it cannot change the
+    /// points-to sets of the queries.
+    void validateSliceTests(void);
+
     /// Whether to allow for reuse at stores.
     bool storeReuse;
     /// Whether to allow reuse at all instructions (load/store/field).
@@ -103,6 +136,14 @@ private:
     DenseMap<NodeID, NodeBS> gepToSVFGRetrievers;
     /// Maps whether a (SVFG) GEP node is a load or not.
     NodeBS loadGeps;
+
+    /// Whether only the backward slice of the queries is solved.
+    bool demandDriven;
+    /// Queried SVFG nodes and top-level PAG nodes.
+    NodeBS queryLocs;
+    NodeBS queryPtrs;
+    /// SVFG nodes which are solved when demand-driven.
+    NodeBS slice;
 };
 
 #endif /* FLOWSENSITIVETYPEFILTER_H_ */
@@ -38,6 +38,7 @@
 #define WPA_H_
 
 #include "MemoryModel/PointerAnalysis.h"
+#include <list>
 
 class SVFModule;
 
@@ -49,8 +50,16 @@ class SVFModule;
 // and I want to see what breaks.
 class WPAPass: public ModulePass {
     typedef std::vector<PointerAnalysis*> PTAVector;
+    typedef std::vector<NodePair> NodePairVector;
+    /// LRU cache of alias results, most recently used first
+    typedef std::list<std::pair<NodePair, AliasResult> > AliasCacheList;
+    typedef llvm::DenseMap<NodePair, AliasCacheList::iterator> AliasCacheMap;
 
 public:
+    typedef std::pair<const Value*, const Value*> ValuePair;
+    typedef std::vector<ValuePair> ValuePairVector;
+    typedef std::vector<AliasResult> AliasResultVector;
+
     /// Pass ID
     static char ID;
 
@@ -61,7 +70,7 @@ public:
     };
 
     /// Constructor needs TargetLibraryInfo to be passed to the AliasAnalysis
-    WPAPass() : ModulePass(ID) {
+    WPAPass() : ModulePass(ID), numOfCheckedAliases(0), numOfAliasMismatches(0) {
 
     }
 
@@ -88,6 +97,10 @@ public:
     /// Interface expose to users of our pointer analysis, given Value infos
     virtual AliasResult alias(const Value* V1,	const Value* V2);
 
+    /// Interface expose to users of our pointer analysis, given a batch of
+    /// Value pairs. results[i] is the alias result of queries[i].
+    virtual void alias(const ValuePairVector& queries, AliasResultVector& results);
+
     /// Print all alias pairs
     virtual void PrintAliasPairs(PointerAnalysis* pta);
 
@@ -110,8 +123,33 @@ private:
     /// Create pointer analysis according to specified kind and analyze the module.
     void runPointerAnalysis(SVFModule svfModule, u32_t kind);
 
+    /// Alias result of a node pair, combined over all pointer analyses by the alias check rule
+    AliasResult computeAlias(const NodePair& pair);
+
+    /// Alias results of node pairs, combined over all pointer analyses by the alias check rule
+    void computeAliases(const NodePairVector& pairs, AliasResultVector& results);
+
+    /// Alias results of node pairs given by a pointer analysis
+    void computeAliases(PointerAnalysis* pta, const NodePairVector& pairs, AliasResultVector& results);
+
+    /// Alias result cache
+    //@{
+    bool getCachedAlias(const NodePair& pair, AliasResult& result);
+    void addCachedAlias(const NodePair& pair, AliasResult result);
+    //@}
+
+    /// Check batched alias results against answering pairs one by one (-check-alias-batch)
+    //@{
+    void validateAliasTests(PointerAnalysis* pta, const NodePairVector& pairs, const AliasResultVector& results);
+    void reportAliasTests(const std::string& source);
+    //@}
+
     PTAVector ptaVector;	///< all pointer analysis to be executed.
     PointerAnalysis* _pta;	///<  pointer analysis to be executed.
+    AliasCacheList aliasCacheList;	///< cached alias results, most recently used first
+    AliasCacheMap aliasCacheMap;	///< node pair to its entry in aliasCacheList
+    u32_t numOfCheckedAliases;	///< pairs checked by -check-alias-batch since the last report
+    u32_t numOfAliasMismatches;	///< checked pairs whose batched result differs
 };
 
 
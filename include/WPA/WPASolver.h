@@ -48,12 +48,13 @@ public:
 
     typedef SCCDetection<GraphType> SCC;
 
-    typedef FIFOWorkList<NodeID> WorkList;
+    typedef NodeWorkList<NodeID> WorkList;
 
 protected:
 
     /// Constructor
-    WPASolver(): _graph(NULL),scc(NULL), reanalyze(false), numOfIteration(0), iterationForPrintStat(1000)
+    WPASolver(): _graph(NULL),scc(NULL), reanalyze(false), numOfIteration(0), iterationForPrintStat(1000),
+        checkTopoPriorities(false), numOfUntopoPriorities(0)
     {
     }
     /// Destructor
@@ -79,9 +80,11 @@ protected:
     }
     //@}
 
-    /// SCC detection
+    /// SCC detection. A detection over the whole graph also refreshes the
+    /// priorities of the TOPO and TWOPHASE worklists.
     virtual inline NodeStack& SCCDetect() {
         getSCCDetector()->find();
+        setTopoPriorities(getSCCDetector()->topoNodeStack());
         return getSCCDetector()->topoNodeStack();
     }
     virtual inline NodeStack& SCCDetect(NodeSet& candidates) {
@@ -104,6 +107,11 @@ protected:
 			if (updateCallGraph())
 				reanalyze = true;
 
+			/// Nodes and edges added or merged in this round make the
+			/// priorities of the last SCC detection stale.
+			if (reanalyze)
+				updateTopoPriorities();
+
 		} while (reanalyze);
     }
 
@@ -116,6 +124,75 @@ protected:
         }
     }
 
+    /// Whether the worklist pops nodes by the priorities of setTopoPriorities
+    inline bool isTopoWorklist() const {
+        return worklist.getStrategy() == WorkList::TOPO || worklist.getStrategy() == WorkList::TWOPHASE;
+    }
+
+    /// Recompute the priorities of the TOPO and TWOPHASE worklists by an SCC
+    /// detection over the whole graph. Cycles are only detected, not merged.
+    virtual inline void updateTopoPriorities() {
+        if (isTopoWorklist()) {
+            getSCCDetector()->find();
+            setTopoPriorities(getSCCDetector()->topoNodeStack());
+        }
+    }
+
+    /// Prioritise the SCCs of nodeStack by their topological order; every
+    /// node of an SCC takes the priority of the SCC. The nodes already in the
+    /// worklist are re-ordered by their new priorities.
+    inline void setTopoPriorities(const NodeStack& nodeStack) {
+        if (!isTopoWorklist())
+            return;
+
+        NodeStack stack(nodeStack);
+        NodeVector reps;
+        u32_t priority = 0;
+        while (!stack.empty()) {
+            NodeID rep = stack.top();
+            stack.pop();
+            const NodeBS& subNodes = getSCCDetector()->subNodes(rep);
+            for (NodeBS::iterator it = subNodes.begin(), eit = subNodes.end(); it != eit; ++it)
+                worklist.setPriority(*it, priority);
+            worklist.setPriority(rep, priority++);
+            reps.push_back(rep);
+        }
+        worklist.reprioritise();
+        if (checkTopoPriorities && !isTopoPrioritised(reps))
+            numOfUntopoPriorities++;
+        assert(isTopoPrioritised(reps) && "TOPO worklist would not pop SCCs in topological order");
+    }
+
+    /// Count the priorities of setTopoPriorities which are not topological
+    //@{
+    inline void setCheckTopoPriorities(bool check) {
+        checkTopoPriorities = check;
+    }
+    inline u32_t getNumOfUntopoPriorities() const {
+        return numOfUntopoPriorities;
+    }
+    //@}
+
+    /// Whether every edge between two SCCs of nodes goes to a higher priority,
+    /// i.e. TOPO and TWOPHASE pop the SCCs in topological order
+    inline bool isTopoPrioritised(const NodeVector& nodes) {
+        for (NodeVector::const_iterator it = nodes.begin(), eit = nodes.end(); it != eit; ++it) {
+            NodeID rep = *it;
+            const NodeBS& subNodes = getSCCDetector()->subNodes(rep);
+            for (NodeBS::iterator sit = subNodes.begin(), seit = subNodes.end(); sit != seit; ++sit) {
+                GNODE node = GTraits::getNode(_graph, *sit);
+                child_iterator EI = GTraits::direct_child_begin(node);
+                child_iterator EE = GTraits::direct_child_end(node);
+                for (; EI != EE; ++EI) {
+                    NodeID dst = getSCCDetector()->repNode(GTraits::getNodeID(*EI));
+                    if (dst != rep && worklist.getPriority(dst) <= worklist.getPriority(rep))
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
     virtual inline void solveWorklist() {
         while (!isWorklistEmpty()) {
             NodeID nodeId = popFromWorklist();
@@ -171,6 +248,10 @@ protected:
     inline bool isInWorklist(NodeID id) {
         return worklist.find(id);
     }
+    /// Order in which nodes are popped; set before anything is pushed.
+    inline void setWorklistStrategy(typename WorkList::Strategy strategy) {
+        worklist.setStrategy(strategy);
+    }
     //@}
 
     /// Reanalyze if any constraint value changed
@@ -202,6 +283,11 @@ protected:
 public:
     /// num of iterations during constaint solving
     u32_t numOfIteration;
+
+private:
+    /// Check every setTopoPriorities by isTopoPrioritised, and count failures
+    bool checkTopoPriorities;
+    u32_t numOfUntopoPriorities;
 };
 
 #endif /* GRAPHSOLVER_H_ */
@@ -79,9 +79,6 @@ public:
  */
 class FlowSensitiveStat : public PTAStat {
 public:
-    typedef FlowSensitive::DFInOutMap DFInOutMap;
-    typedef FlowSensitive::PtsMap PtsMap;
-
     FlowSensitive * fspta;
 
     FlowSensitiveStat(FlowSensitive* pta): PTAStat(pta) {
@@ -110,7 +107,7 @@ private:
 
     void calculateAddrVarPts(NodeID pointer, const SVFGNode* node);
 
-    void statInOutPtsSize(const DFInOutMap& data, ENUM_INOUT inOrOut);
+    void statInOutPtsSize(ENUM_INOUT inOrOut);
 
     u32_t _NumOfNullPtr;
     u32_t _NumOfConstantPtr;
@@ -10,8 +10,12 @@
 
 #include "DDA/DDAClient.h"
 #include "DDA/FlowDDA.h"
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <fstream>
 #include <iostream>
 #include <iomanip>	// for std::setw
+#include <sstream>
 
 using namespace SVFUtil;
 
@@ -42,6 +46,9 @@ static llvm::cl::opt<bool> TaintUninitHeap("uninit-heap", llvm::cl::init(true),
 static llvm::cl::opt<bool> TaintUninitStack("uninit-stack", llvm::cl::init(true),
                                       llvm::cl::desc("detect uninitialized stack variables"));
 
+static llvm::cl::opt<bool> OrderQueries("order-queries", llvm::cl::init(false),
+                                   llvm::cl::desc("Answer queries in the topological order of their definitions on the SVFG"));
+
 void DDAClient::answerQueries(PointerAnalysis* pta) {
 
     DDAStat* stat = static_cast<DDAStat*>(pta->getStat());
@@ -51,26 +58,182 @@ void DDAClient::answerQueries(PointerAnalysis* pta) {
     stat->setMemUsageBefore(vmrss, vmsize);
 
     collectCandidateQueries(pta->getPAG());
-
-    u32_t count = 0;
-    for (NodeSet::iterator nIter = candidateQueries.begin();
-            nIter != candidateQueries.end(); ++nIter,++count) {
-        PAGNode* node = pta->getPAG()->getPAGNode(*nIter);
-        if(pta->getPAG()->isValidTopLevelPtr(node)) {
-            DBOUT(DGENERAL,outs() << "\n@@Computing PointsTo for :" << node->getId() <<
-                  " [" << count + 1<< "/" << candidateQueries.size() << "]" << " \n");
-            DBOUT(DDDA,outs() << "\n@@Computing PointsTo for :" << node->getId() <<
-                  " [" << count + 1<< "/" << candidateQueries.size() << "]" << " \n");
-            setCurrentQueryPtr(node->getId());
-            pta->computeDDAPts(node->getId());
-        }
-    }
+    NodeVector queries(candidateQueries.begin(), candidateQueries.end());
+    answerQueries(pta, queries);
 
     vmrss = vmsize = 0;
     SVFUtil::getMemoryUsageKB(&vmrss, &vmsize);
     stat->setMemUsageAfter(vmrss, vmsize);
 }
 
+/*!
+ * The analysis keeps the points-to it caches from one query to the next,
+ * so queries are ordered (-order-queries) for the later ones to reuse the
+ * results of the earlier ones.
+ */
+void DDAClient::answerQueries(PointerAnalysis* pta, const NodeVector& queries) {
+    NodeVector pending;
+    for (NodeVector::const_iterator it = queries.begin(), eit = queries.end(); it != eit; ++it) {
+        PAGNode* node = pta->getPAG()->getPAGNode(*it);
+        if (pta->getPAG()->isValidTopLevelPtr(node) && !answeredQueries.test(*it))
+            pending.push_back(*it);
+    }
+    if (OrderQueries)
+        pta->orderDDAQueries(pending);
+
+    for (u32_t count = 0; count < pending.size(); ++count) {
+        NodeID id = pending[count];
+        DBOUT(DGENERAL,outs() << "\n@@Computing PointsTo for :" << id <<
+              " [" << count + 1<< "/" << pending.size() << "]" << " \n");
+        DBOUT(DDDA,outs() << "\n@@Computing PointsTo for :" << id <<
+              " [" << count + 1<< "/" << pending.size() << "]" << " \n");
+        setCurrentQueryPtr(id);
+        pta->computeDDAPts(id);
+        answeredQueries.set(id);
+    }
+}
+
+/*!
+ * Store a "query -> { obj1 obj2 }" line per answered query. Points-to are
+ * those after the analysis is finalized.
+ */
+void DDAClient::writeQueryResults(PointerAnalysis* pta, const std::string& filename) const {
+    outs() << "Storing query results to '" << filename << "'...";
+
+    std::error_code err;
+    llvm::ToolOutputFile F(filename.c_str(), err, llvm::sys::fs::F_None);
+    if (err) {
+        outs() << "  error opening file for writing!\n";
+        F.os().clear_error();
+        return;
+    }
+
+    writeQueryResults(pta, F.os());
+
+    F.os().close();
+    if (!F.os().has_error()) {
+        outs() << "\n";
+        F.keep();
+    }
+}
+
+void DDAClient::writeQueryResults(PointerAnalysis* pta, raw_ostream& os) const {
+    for (NodeBS::iterator it = answeredQueries.begin(), eit = answeredQueries.end(); it != eit; ++it) {
+        const PointsTo& pts = pta->getPts(*it);
+        os << *it << " -> { ";
+        for (PointsTo::iterator pit = pts.begin(), epit = pts.end(); pit != epit; ++pit)
+            os << *pit << " ";
+        os << "}\n";
+    }
+}
+
+/*!
+ * Seed the points-to of the queries stored by writeQueryResults, which are
+ * then skipped by answerQueries
+ */
+bool DDAClient::readQueryResults(PointerAnalysis* pta, const std::string& filename) {
+    outs() << "Loading query results from '" << filename << "'...";
+
+    QueryResults results;
+    if (!parseQueryResults(pta, filename, results)) {
+        outs() << "  error opening file for reading!\n";
+        return false;
+    }
+
+    for (QueryResults::const_iterator it = results.begin(), eit = results.end(); it != eit; ++it) {
+        pta->seedDDAPts(it->first, it->second);
+        answeredQueries.set(it->first);
+    }
+
+    outs() << "  " << results.size() << " query results loaded\n";
+    return true;
+}
+
+/*!
+ * Parse the lines of a file stored by writeQueryResults. Lines with unknown
+ * nodes or which are truncated are skipped.
+ */
+bool DDAClient::parseQueryResults(PointerAnalysis* pta, const std::string& filename, QueryResults& results) const {
+    std::ifstream F(filename.c_str());
+    if (!F.is_open())
+        return false;
+
+    std::string line;
+    while (std::getline(F, line)) {
+        std::istringstream ss(line);
+        NodeID id;
+        std::string arrow, brace;
+        if (!(ss >> id >> arrow >> brace) || arrow != "->" || brace != "{")
+            continue;
+        if (!pta->getPAG()->hasGNode(id))
+            continue;
+
+        /// Reject the whole line if any object is unknown or the set is truncated
+        PointsTo pts;
+        NodeID obj;
+        bool valid = true;
+        while (valid && ss >> obj) {
+            if (pta->getPAG()->hasGNode(obj))
+                pts.set(obj);
+            else
+                valid = false;
+        }
+        if (!valid)
+            continue;
+        ss.clear();
+        if (!(ss >> brace) || brace != "}")
+            continue;
+
+        results[id] = pts;
+    }
+    F.close();
+    return true;
+}
+
+/*!
+ * Store the answered queries to a temporary file, parse it back and compare
+ * with the points-to of the analysis
+ */
+void DDAClient::validateQueryResultsTests(PointerAnalysis* pta) const {
+    outs() << "[" << pta->PTAName() << "] Checking the stored results of " << answeredQueries.count() << " queries are read back unchanged\n";
+
+    llvm::SmallString<128> path;
+    int fd;
+    if (llvm::sys::fs::createTemporaryFile("svf-queries", "txt", fd, path)) {
+        SVFUtil::errs() << errMsg("\t FAIL :") << "cannot create a temporary file\n";
+        return;
+    }
+    {
+        raw_fd_ostream os(fd, true);
+        writeQueryResults(pta, os);
+    }
+
+    QueryResults results;
+    bool parsed = parseQueryResults(pta, path.str().str(), results);
+    llvm::sys::fs::remove(path);
+    if (!parsed) {
+        SVFUtil::errs() << errMsg("\t FAIL :") << "the query results cannot be parsed\n";
+        return;
+    }
+
+    u32_t numOfFailures = 0;
+    if (results.size() != answeredQueries.count()) {
+        numOfFailures++;
+        SVFUtil::errs() << errMsg("\t FAIL :") << results.size() << " query results read back for "
+                        << answeredQueries.count() << " answered queries\n";
+    }
+    for (NodeBS::iterator it = answeredQueries.begin(), eit = answeredQueries.end(); it != eit; ++it) {
+        QueryResults::const_iterator rit = results.find(*it);
+        if ((rit == results.end() || rit->second != pta->getPts(*it)) && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << "the result of query <id:" << *it << "> differs when read back\n";
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << answeredQueries.count() << " query results are read back unchanged\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " query results are not read back unchanged\n";
+}
+
 void FunptrDDAClient::performStat(PointerAnalysis* pta) {
 
     AndersenWaveDiff* ander = AndersenWaveDiff::createAndersenWaveDiff(pta->getModule());
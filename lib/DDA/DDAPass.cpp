@@ -41,6 +41,15 @@ static llvm::cl::opt<bool> printQueryPts("print-query-pts", llvm::cl::init(false
 static llvm::cl::opt<bool> WPANUM("wpanum", llvm::cl::init(false),
                             llvm::cl::desc("collect WPA FS number only "));
 
+static llvm::cl::opt<string> WriteDDAQueries("write-dda-queries", llvm::cl::init(""),
+                                     llvm::cl::desc("Write the points-to of the answered queries to a file"));
+
+static llvm::cl::opt<string> ReadDDAQueries("read-dda-queries", llvm::cl::init(""),
+                                    llvm::cl::desc("Read the points-to of queries answered by a previous run on the same module"));
+
+static llvm::cl::opt<bool> CheckDDAQueries("check-dda-queries", llvm::cl::init(false),
+                                     llvm::cl::desc("Check the results of the answered queries are read back unchanged after storing them"));
+
 static llvm::RegisterPass<DDAPass> DDAPA("dda", "Demand-driven Pointer Analysis Pass");
 
 /// register this into alias analysis group
@@ -134,10 +143,17 @@ void DDAPass::runPointerAnalysis(SVFModule module, u32_t kind)
     else {
         ///initialize
         _pta->initialize(module);
+        _client->clearAnsweredQueries();
+        if (!ReadDDAQueries.empty())
+            _client->readQueryResults(_pta, ReadDDAQueries);
         ///compute points-to
         _client->answerQueries(_pta);
         ///finalize
         _pta->finalize();
+        if (!WriteDDAQueries.empty())
+            _client->writeQueryResults(_pta, WriteDDAQueries);
+        if (CheckDDAQueries)
+            _client->validateQueryResultsTests(_pta);
         if(printCPts)
             _pta->dumpCPts();
 
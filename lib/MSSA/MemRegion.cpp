@@ -35,7 +35,7 @@
 using namespace SVFUtil;
 
 Size_t MemRegion::totalMRNum = 0;
-Size_t MRVer::totalVERNum = 0;
+std::atomic<Size_t> MRVer::totalVERNum(0);
 
 static llvm::cl::opt<bool> IgnoreDeadFun("mssa-ignoreDeadFun", llvm::cl::init(false),
                                    llvm::cl::desc("Don't construct memory SSA for deadfunction"));
@@ -213,11 +213,11 @@ void MRGenerator::collectModRefForCall() {
     for(PAG::CallSiteSet::const_iterator it =  pta->getPAG()->getCallSiteSet().begin(),
             eit = pta->getPAG()->getCallSiteSet().end(); it!=eit; ++it) {
         if(hasRefSideEffectOfCallSite(*it)) {
-            NodeBS refs = getRefSideEffectOfCallSite(*it);
+            PointsTo refs(getRefSideEffectOfCallSite(*it));
             addCPtsToCallSiteRefs(refs,*it);
         }
         if(hasModSideEffectOfCallSite(*it)) {
-            NodeBS mods = getModSideEffectOfCallSite(*it);
+            PointsTo mods(getModSideEffectOfCallSite(*it));
             addCPtsToCallSiteMods(mods,*it);
         }
     }
@@ -439,11 +439,11 @@ NodeBS& MRGenerator::CollectPtsChain(NodeID id) {
     if(it!=cachedPtsChainMap.end())
         return it->second;
     else {
-        PointsTo& pts = cachedPtsChainMap[baseId];
+        NodeBS& pts = cachedPtsChainMap[baseId];
         pts |= pta->getPAG()->getFieldsAfterCollapse(baseId);
 
         WorkList worklist;
-        for(PointsTo::iterator it = pts.begin(), eit = pts.end(); it!=eit; ++it)
+        for(NodeBS::iterator it = pts.begin(), eit = pts.end(); it!=eit; ++it)
             worklist.push(*it);
 
         while(!worklist.empty()) {
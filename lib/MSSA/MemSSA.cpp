@@ -31,6 +31,8 @@
 #include "MSSA/MemSSA.h"
 #include "Util/SVFUtil.h"
 #include "MSSA/SVFGStat.h"
+#include "MSSA/SVFGBuilder.h"
+#include "Util/Parallel.h"
 
 using namespace SVFUtil;
 
@@ -55,7 +57,7 @@ double MemSSA::timeOfSSARenaming  = 0;	///< Time for SSA rename
 /*!
  * Constructor
  */
-MemSSA::MemSSA(BVDataPTAImpl* p, bool ptrOnlyMSSA) : df(NULL),dt(NULL) {
+MemSSA::MemSSA(BVDataPTAImpl* p, bool ptrOnlyMSSA) : df(NULL),dt(NULL),owner(NULL) {
     pta = p;
     assert((pta->getAnalysisTy()!=PointerAnalysis::Default_PTA)
            && "please specify a pointer analysis");
@@ -84,6 +86,12 @@ MemSSA::MemSSA(BVDataPTAImpl* p, bool ptrOnlyMSSA) : df(NULL),dt(NULL) {
     timeOfGeneratingMemRegions += (mrEnd - mrStart)/TIMEINTERVAL;
 }
 
+/*!
+ * Constructor of a MemSSA sharing the memory regions of owner
+ */
+MemSSA::MemSSA(MemSSA* o) : pta(o->pta), mrGen(o->mrGen), df(NULL), dt(NULL), stat(o->stat), owner(o) {
+}
+
 /*!
  * Set DF/DT
  */
@@ -106,24 +114,206 @@ void MemSSA::buildMemSSA(const Function& fun, DominanceFrontier* f, DominatorTre
 
     setCurrentDFDT(f,t);
 
+    // Phase times are process CPU times, which are meaningless per thread,
+    // so they are not recorded when building on several threads.
+    bool recordTime = (owner == NULL);
+
     /// Create mus/chis for loads/stores/calls for memory regions
     double muchiStart = stat->getClk();
     createMUCHI(fun);
     double muchiEnd = stat->getClk();
-    timeOfCreateMUCHI += (muchiEnd - muchiStart)/TIMEINTERVAL;
+    if (recordTime)
+        timeOfCreateMUCHI += (muchiEnd - muchiStart)/TIMEINTERVAL;
 
     /// Insert PHI for memory regions
     double phiStart = stat->getClk();
     insertPHI(fun);
     double phiEnd = stat->getClk();
-    timeOfInsertingPHI += (phiEnd - phiStart)/TIMEINTERVAL;
+    if (recordTime)
+        timeOfInsertingPHI += (phiEnd - phiStart)/TIMEINTERVAL;
 
     /// SSA rename for memory regions
     double renameStart = stat->getClk();
     SSARename(fun);
     double renameEnd = stat->getClk();
-    timeOfSSARenaming += (renameEnd - renameStart)/TIMEINTERVAL;
+    if (recordTime)
+        timeOfSSARenaming += (renameEnd - renameStart)/TIMEINTERVAL;
+
+}
+
+/*!
+ * Build memory SSA for funs on numThreads threads.
+ * The memory SSA of a function only depends on the function and the memory
+ * regions, so each thread builds its share of the functions, computing their
+ * dominators, in a MemSSA of its own sharing the regions of this one. The
+ * mus, chis and phis are then moved into this one.
+ */
+void MemSSA::buildMemSSA(const std::vector<Function*>& funs, u32_t numThreads) {
+    // Looking the regions of a load or store up inserts an empty set if it
+    // has none, so every load and store is looked up before going parallel.
+    PAG* pag = getPAG();
+    for (const PAGEdge* edge : pag->getEdgeSet(PAGEdge::Load))
+        mrGen->getLoadMRSet(SVFUtil::cast<LoadPE>(edge));
+    for (const PAGEdge* edge : pag->getEdgeSet(PAGEdge::Store))
+        mrGen->getStoreMRSet(SVFUtil::cast<StorePE>(edge));
+
+    numThreads = std::max(1u, std::min<u32_t>(numThreads, funs.size()));
+    std::vector<MemSSA*> threadMSSAs(numThreads);
+    for (u32_t t = 0; t < numThreads; ++t)
+        threadMSSAs[t] = new MemSSA(this);
+
+    // The threads must not write to outs(), so the warnings of each function
+    // are kept and printed after the join, in the order of funs.
+    std::vector<std::vector<std::string> > funWarnings(funs.size());
+    std::atomic<u32_t> next(0);
+    SVFUtil::parallelFor(0, numThreads, [&](u32_t t) {
+        DominatorTree dt;
+        MemSSADF df;
+        for (u32_t i = next++; i < funs.size(); i = next++) {
+            dt.recalculate(*funs[i]);
+            df.runOnDT(dt);
+            threadMSSAs[t]->buildMemSSA(*funs[i], &df, &dt);
+            funWarnings[i].swap(threadMSSAs[t]->pendingWarnings);
+        }
+    }, numThreads, 1);
+
+    for (u32_t i = 0; i < funs.size(); ++i) {
+        for (u32_t w = 0; w < funWarnings[i].size(); ++w)
+            writeWrnMsg(funWarnings[i][w]);
+    }
+
+    for (u32_t t = 0; t < numThreads; ++t) {
+        threadMSSAs[t]->moveInto(this);
+        threadMSSAs[t]->mrGen = NULL;
+        threadMSSAs[t]->stat = NULL;
+        delete threadMSSAs[t];
+    }
+}
+
+/*!
+ * Print a warning. A MemSSA building functions on a thread keeps it in
+ * pendingWarnings instead, for its owner to print.
+ */
+void MemSSA::warn(const std::string& msg) {
+    if (owner)
+        pendingWarnings.push_back(msg);
+    else
+        writeWrnMsg(msg);
+}
 
+/*!
+ * Move the entries of from into to, whose keys are different.
+ */
+template<typename MapTy>
+static inline void moveMapEntries(MapTy& from, MapTy& to) {
+    for (typename MapTy::iterator it = from.begin(), eit = from.end(); it != eit; ++it)
+        to[it->first].swap(it->second);
+    from.clear();
+}
+
+/*!
+ * The functions built by different MemSSAs are different, and so are the
+ * keys of their maps.
+ */
+void MemSSA::moveInto(MemSSA* mssa) {
+    moveMapEntries(load2MuSetMap, mssa->load2MuSetMap);
+    moveMapEntries(store2ChiSetMap, mssa->store2ChiSetMap);
+    moveMapEntries(callsiteToMuSetMap, mssa->callsiteToMuSetMap);
+    moveMapEntries(callsiteToChiSetMap, mssa->callsiteToChiSetMap);
+    moveMapEntries(bb2PhiSetMap, mssa->bb2PhiSetMap);
+    moveMapEntries(funToEntryChiSetMap, mssa->funToEntryChiSetMap);
+    moveMapEntries(funToReturnMuSetMap, mssa->funToReturnMuSetMap);
+}
+
+/// Regions and SSA versions of a set of mus, chis or phis, to compare those
+/// of two MemSSAs sharing their regions
+typedef std::set<std::pair<const MemRegion*, std::vector<VERSION> > > MSSASignature;
+
+static MSSASignature getSignature(const MemSSA::MUSet& mus) {
+    MSSASignature sig;
+    for (const MemSSA::MU* mu : mus)
+        sig.insert(std::make_pair(mu->getMR(), std::vector<VERSION>(1, mu->getVer()->getSSAVersion())));
+    return sig;
+}
+static MSSASignature getSignature(const MemSSA::CHISet& chis) {
+    MSSASignature sig;
+    for (const MemSSA::CHI* chi : chis) {
+        std::vector<VERSION> vers;
+        vers.push_back(chi->getOpVer()->getSSAVersion());
+        vers.push_back(chi->getResVer()->getSSAVersion());
+        sig.insert(std::make_pair(chi->getMR(), vers));
+    }
+    return sig;
+}
+static MSSASignature getSignature(const MemSSA::PHISet& phis) {
+    MSSASignature sig;
+    for (const MemSSA::PHI* phi : phis) {
+        // Operands by position, then the result
+        std::map<u32_t, VERSION> opVers;
+        for (MemSSA::PHI::OPVers::const_iterator it = phi->opVerBegin(), eit = phi->opVerEnd(); it != eit; ++it)
+            opVers[it->first] = it->second->getSSAVersion();
+        std::vector<VERSION> vers;
+        for (const std::pair<const u32_t, VERSION>& opVer : opVers) {
+            vers.push_back(opVer.first);
+            vers.push_back(opVer.second);
+        }
+        vers.push_back(phi->getResVer()->getSSAVersion());
+        sig.insert(std::make_pair(phi->getMR(), vers));
+    }
+    return sig;
+}
+
+/*!
+ * Number of keys of lhs and rhs whose mus, chis or phis differ
+ */
+template<typename MapTy>
+static u32_t getNumOfDiffEntries(const MapTy& lhs, const MapTy& rhs) {
+    u32_t numOfDiffs = 0;
+    for (typename MapTy::const_iterator it = lhs.begin(), eit = lhs.end(); it != eit; ++it) {
+        typename MapTy::const_iterator rit = rhs.find(it->first);
+        if (rit == rhs.end() || getSignature(it->second) != getSignature(rit->second))
+            numOfDiffs++;
+    }
+    for (typename MapTy::const_iterator it = rhs.begin(), eit = rhs.end(); it != eit; ++it) {
+        if (lhs.find(it->first) == lhs.end())
+            numOfDiffs++;
+    }
+    return numOfDiffs;
+}
+
+/*!
+ * Build the memory SSA of funs again on this thread, in a MemSSA sharing the
+ * regions of this one, and compare their mus, chis and phis region by region
+ * and version by version.
+ */
+void MemSSA::validateParallelTests(const std::vector<Function*>& funs) {
+    outs() << "[" << pta->PTAName() << "] Checking the memory SSA built on several threads\n";
+
+    MemSSA* reference = new MemSSA(this);
+    DominatorTree dt;
+    MemSSADF df;
+    for (Function* fun : funs) {
+        dt.recalculate(*fun);
+        df.runOnDT(dt);
+        reference->buildMemSSA(*fun, &df, &dt);
+    }
+
+    u32_t numOfDiffs = getNumOfDiffEntries(load2MuSetMap, reference->load2MuSetMap)
+                       + getNumOfDiffEntries(store2ChiSetMap, reference->store2ChiSetMap)
+                       + getNumOfDiffEntries(callsiteToMuSetMap, reference->callsiteToMuSetMap)
+                       + getNumOfDiffEntries(callsiteToChiSetMap, reference->callsiteToChiSetMap)
+                       + getNumOfDiffEntries(bb2PhiSetMap, reference->bb2PhiSetMap)
+                       + getNumOfDiffEntries(funToEntryChiSetMap, reference->funToEntryChiSetMap)
+                       + getNumOfDiffEntries(funToReturnMuSetMap, reference->funToReturnMuSetMap);
+
+    reference->mrGen = NULL;
+    reference->stat = NULL;
+    delete reference;
+
+    if (numOfDiffs == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the memory SSA of " << funs.size() << " functions is the one built on a single thread\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfDiffs << " loads, stores, callsites, blocks or functions have different mus, chis or phis\n";
 }
 
 /*!
@@ -198,10 +388,13 @@ void MemSSA::createMUCHI(const Function& fun) {
 
         /// if the function does not have a reachable return instruction from function entry
         /// then we won't create return mu for it
-        if(functionDoesNotRet(&fun) == false) {
+        if(functionDoesNotRet(&fun, false) == false) {
             RETMU* mu = new RETMU(&fun, mr);
             funToReturnMuSetMap[&fun].insert(mu);
         }
+        else if (isProgEntryFunction(&fun) == false) {
+            warn(fun.getName().str() + " does not have return");
+        }
 
     }
 
@@ -230,7 +423,7 @@ void MemSSA::insertPHI(const Function& fun) {
             bbs.pop_back();
             DominanceFrontierBase::const_iterator it = df->find(const_cast<BasicBlock*>(bb));
             if(it == df->end()) {
-                writeWrnMsg("bb not in the dominance frontier map??");
+                warn("bb not in the dominance frontier map??");
                 continue;
             }
             const DominanceFrontierBase::DomSetType& domSet = it->second;
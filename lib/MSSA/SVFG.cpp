@@ -32,6 +32,7 @@
 #include "MSSA/SVFGStat.h"
 #include "Util/SVFUtil.h"
 #include "Util/SVFModule.h"
+#include "Util/Parallel.h"
 
 using namespace SVFUtil;
 
@@ -39,6 +40,12 @@ using namespace SVFUtil;
 static llvm::cl::opt<bool> DumpVFG("dump-svfg", llvm::cl::init(false),
                              llvm::cl::desc("Dump dot graph of SVFG"));
 
+static llvm::cl::opt<bool> ParallelSVFG("parallel-svfg", llvm::cl::init(false),
+                             llvm::cl::desc("Connect indirect SVFG edges on several threads (see -svf-threads)"));
+
+static llvm::cl::opt<bool> CheckParallelSVFG("check-parallel-svfg", llvm::cl::init(false),
+                             llvm::cl::desc("Check the indirect SVFG edges found with -parallel-svfg against those found on a single thread"));
+
 /*!
  * Constructor
  */
@@ -134,81 +141,194 @@ void SVFG::addSVFGNodesForAddrTakenVars() {
 
 /*
  * Connect def-use chains for indirect value-flow, (value-flow of address-taken variables)
+ * With several threads (see -parallel-svfg), the edges into each node are collected
+ * concurrently, then added to the graph in node order, so the graph does not depend
+ * on scheduling. With one thread they are added as they are found, in the same order.
  */
 void SVFG::connectIndirectSVFGEdges() {
 
-    for(iterator it = begin(), eit = end(); it!=eit; ++it) {
-        NodeID nodeId = it->first;
-        const SVFGNode* node = it->second;
-        if(const LoadSVFGNode* loadNode = SVFUtil::dyn_cast<LoadSVFGNode>(node)) {
-            MUSet& muSet = mssa->getMUSet(SVFUtil::cast<LoadPE>(loadNode->getPAGEdge()));
-            for(MUSet::iterator it = muSet.begin(), eit = muSet.end(); it!=eit; ++it) {
-                if(LOADMU* mu = SVFUtil::dyn_cast<LOADMU>(*it)) {
-                    NodeID def = getDef(mu->getVer());
-                    addIntraIndirectVFEdge(def,nodeId, mu->getVer()->getMR()->getPointsTo());
-                }
-            }
+    IDToSVFGNodeList nodes;
+    for(iterator it = begin(), eit = end(); it!=eit; ++it)
+        nodes.push_back(std::make_pair(it->first, it->second));
+
+    u32_t numThreads = ParallelSVFG ? SVFUtil::getNumOfPtsWorkers() : 1;
+
+    if (numThreads <= 1) {
+        for(u32_t i = 0; i < nodes.size(); ++i)
+            collectIndirectSVFGEdges(nodes[i].first, nodes[i].second, NULL);
+    }
+    else {
+        std::vector<IndirectEdgeInfos> edges(nodes.size());
+        parallelFor(0, nodes.size(), [&](u32_t i) {
+            collectIndirectSVFGEdges(nodes[i].first, nodes[i].second, &edges[i]);
+        }, numThreads);
+
+        if (CheckParallelSVFG)
+            validateParallelTests(nodes, edges);
+
+        for(u32_t i = 0; i < edges.size(); ++i) {
+            for(IndirectEdgeInfos::const_iterator it = edges[i].begin(), eit = edges[i].end(); it!=eit; ++it)
+                addIndirectSVFGEdge(it->kind, it->src, it->dst, it->cpts, it->csId);
         }
-        else if(const StoreSVFGNode* storeNode = SVFUtil::dyn_cast<StoreSVFGNode>(node)) {
-            CHISet& chiSet = mssa->getCHISet(SVFUtil::cast<StorePE>(storeNode->getPAGEdge()));
-            for(CHISet::iterator it = chiSet.begin(), eit = chiSet.end(); it!=eit; ++it) {
-                if(STORECHI* chi = SVFUtil::dyn_cast<STORECHI>(*it)) {
-                    NodeID def = getDef(chi->getOpVer());
-                    addIntraIndirectVFEdge(def,nodeId, chi->getOpVer()->getMR()->getPointsTo());
-                }
+    }
+
+    connectFromGlobalToProgEntry();
+}
+
+/*!
+ * Find the indirect edges connecting a node to its definitions (and a formal-in/out
+ * node to its callsites). When collecting, only lookups are done, so nodes can be
+ * handled concurrently.
+ */
+void SVFG::collectIndirectSVFGEdges(NodeID nodeId, const SVFGNode* node, IndirectEdgeInfos* edges) {
+    if(const LoadSVFGNode* loadNode = SVFUtil::dyn_cast<LoadSVFGNode>(node)) {
+        const LoadPE* load = SVFUtil::cast<LoadPE>(loadNode->getPAGEdge());
+        MemSSA::LoadToMUSetMap::const_iterator muIt = mssa->getLoadToMUSetMap().find(load);
+        if(muIt == mssa->getLoadToMUSetMap().end())
+            return;
+        for(MUSet::const_iterator it = muIt->second.begin(), eit = muIt->second.end(); it!=eit; ++it) {
+            if(LOADMU* mu = SVFUtil::dyn_cast<LOADMU>(*it)) {
+                NodeID def = getDef(mu->getVer());
+                collectIndirectSVFGEdge(IndirectEdgeInfo::Intra, def, nodeId, mu->getVer()->getMR()->getPointsTo(), 0, edges);
             }
         }
-        else if(const FormalINSVFGNode* formalIn = SVFUtil::dyn_cast<FormalINSVFGNode>(node)) {
-            PTACallGraphEdge::CallInstSet callInstSet;
-            mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(formalIn->getEntryChi()->getFunction(),callInstSet);
-            for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
-                CallSite cs = SVFUtil::getLLVMCallSite(*it);
-                if(!mssa->hasMU(cs))
-                    continue;
-                ActualINSVFGNodeSet& actualIns = getActualINSVFGNodes(cs);
-                for(ActualINSVFGNodeSet::iterator ait = actualIns.begin(), aeit = actualIns.end(); ait!=aeit; ++ait) {
-                    const ActualINSVFGNode* actualIn = SVFUtil::cast<ActualINSVFGNode>(getSVFGNode(*ait));
-                    addInterIndirectVFCallEdge(actualIn,formalIn,getCallSiteID(cs, formalIn->getFun()));
-                }
+    }
+    else if(const StoreSVFGNode* storeNode = SVFUtil::dyn_cast<StoreSVFGNode>(node)) {
+        const StorePE* store = SVFUtil::cast<StorePE>(storeNode->getPAGEdge());
+        MemSSA::StoreToChiSetMap::const_iterator chiIt = mssa->getStoreToChiSetMap().find(store);
+        if(chiIt == mssa->getStoreToChiSetMap().end())
+            return;
+        for(CHISet::const_iterator it = chiIt->second.begin(), eit = chiIt->second.end(); it!=eit; ++it) {
+            if(STORECHI* chi = SVFUtil::dyn_cast<STORECHI>(*it)) {
+                NodeID def = getDef(chi->getOpVer());
+                collectIndirectSVFGEdge(IndirectEdgeInfo::Intra, def, nodeId, chi->getOpVer()->getMR()->getPointsTo(), 0, edges);
             }
         }
-        else if(const FormalOUTSVFGNode* formalOut = SVFUtil::dyn_cast<FormalOUTSVFGNode>(node)) {
-            PTACallGraphEdge::CallInstSet callInstSet;
-            const MemSSA::RETMU* retMu = formalOut->getRetMU();
-            mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(retMu->getFunction(),callInstSet);
-            for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
-                CallSite cs = SVFUtil::getLLVMCallSite(*it);
-                if(!mssa->hasCHI(cs))
-                    continue;
-                ActualOUTSVFGNodeSet& actualOuts = getActualOUTSVFGNodes(cs);
-                for(ActualOUTSVFGNodeSet::iterator ait = actualOuts.begin(), aeit = actualOuts.end(); ait!=aeit; ++ait) {
-                    const ActualOUTSVFGNode* actualOut = SVFUtil::cast<ActualOUTSVFGNode>(getSVFGNode(*ait));
-                    addInterIndirectVFRetEdge(formalOut,actualOut,getCallSiteID(cs, formalOut->getFun()));
-                }
+    }
+    else if(const FormalINSVFGNode* formalIn = SVFUtil::dyn_cast<FormalINSVFGNode>(node)) {
+        PTACallGraphEdge::CallInstSet callInstSet;
+        mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(formalIn->getEntryChi()->getFunction(),callInstSet);
+        for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
+            CallSite cs = SVFUtil::getLLVMCallSite(*it);
+            if(!mssa->hasMU(cs))
+                continue;
+            CallSiteToActualINsMapTy::const_iterator ainIt = callSiteToActualINMap.find(cs);
+            if(ainIt == callSiteToActualINMap.end())
+                continue;
+            CallSiteID csId = getCallSiteID(cs, formalIn->getFun());
+            for(ActualINSVFGNodeSet::iterator ait = ainIt->second.begin(), aeit = ainIt->second.end(); ait!=aeit; ++ait) {
+                const ActualINSVFGNode* actualIn = SVFUtil::cast<ActualINSVFGNode>(getSVFGNode(*ait));
+                PointsTo cpts;
+                if(getInterIndirectVFPts(actualIn->getPointsTo(), formalIn->getPointsTo(), cpts))
+                    collectIndirectSVFGEdge(IndirectEdgeInfo::Call, *ait, nodeId, cpts, csId, edges);
             }
-            NodeID def = getDef(retMu->getVer());
-            addIntraIndirectVFEdge(def,nodeId, retMu->getVer()->getMR()->getPointsTo());
-        }
-        else if(const ActualINSVFGNode* actualIn = SVFUtil::dyn_cast<ActualINSVFGNode>(node)) {
-            const MRVer* ver = actualIn->getCallMU()->getVer();
-            NodeID def = getDef(ver);
-            addIntraIndirectVFEdge(def,nodeId, ver->getMR()->getPointsTo());
         }
-        else if(SVFUtil::isa<ActualOUTSVFGNode>(node)) {
-            /// There's no need to connect actual out node to its definition site in the same function.
-        }
-        else if(const MSSAPHISVFGNode* phiNode = SVFUtil::dyn_cast<MSSAPHISVFGNode>(node)) {
-            for (MemSSA::PHI::OPVers::const_iterator it = phiNode->opVerBegin(), eit = phiNode->opVerEnd();
-                    it != eit; it++) {
-                const MRVer* op = it->second;
-                NodeID def = getDef(op);
-                addIntraIndirectVFEdge(def,nodeId, op->getMR()->getPointsTo());
+    }
+    else if(const FormalOUTSVFGNode* formalOut = SVFUtil::dyn_cast<FormalOUTSVFGNode>(node)) {
+        PTACallGraphEdge::CallInstSet callInstSet;
+        const MemSSA::RETMU* retMu = formalOut->getRetMU();
+        mssa->getPTA()->getPTACallGraph()->getDirCallSitesInvokingCallee(retMu->getFunction(),callInstSet);
+        for(PTACallGraphEdge::CallInstSet::iterator it = callInstSet.begin(), eit = callInstSet.end(); it!=eit; ++it) {
+            CallSite cs = SVFUtil::getLLVMCallSite(*it);
+            if(!mssa->hasCHI(cs))
+                continue;
+            CallSiteToActualOUTsMapTy::const_iterator aoutIt = callSiteToActualOUTMap.find(cs);
+            if(aoutIt == callSiteToActualOUTMap.end())
+                continue;
+            CallSiteID csId = getCallSiteID(cs, formalOut->getFun());
+            for(ActualOUTSVFGNodeSet::iterator ait = aoutIt->second.begin(), aeit = aoutIt->second.end(); ait!=aeit; ++ait) {
+                const ActualOUTSVFGNode* actualOut = SVFUtil::cast<ActualOUTSVFGNode>(getSVFGNode(*ait));
+                PointsTo cpts;
+                if(getInterIndirectVFPts(formalOut->getPointsTo(), actualOut->getPointsTo(), cpts))
+                    collectIndirectSVFGEdge(IndirectEdgeInfo::Ret, nodeId, *ait, cpts, csId, edges);
             }
         }
+        NodeID def = getDef(retMu->getVer());
+        collectIndirectSVFGEdge(IndirectEdgeInfo::Intra, def, nodeId, retMu->getVer()->getMR()->getPointsTo(), 0, edges);
+    }
+    else if(const ActualINSVFGNode* actualIn = SVFUtil::dyn_cast<ActualINSVFGNode>(node)) {
+        const MRVer* ver = actualIn->getCallMU()->getVer();
+        NodeID def = getDef(ver);
+        collectIndirectSVFGEdge(IndirectEdgeInfo::Intra, def, nodeId, ver->getMR()->getPointsTo(), 0, edges);
+    }
+    else if(SVFUtil::isa<ActualOUTSVFGNode>(node)) {
+        /// There's no need to connect actual out node to its definition site in the same function.
     }
+    else if(const MSSAPHISVFGNode* phiNode = SVFUtil::dyn_cast<MSSAPHISVFGNode>(node)) {
+        for (MemSSA::PHI::OPVers::const_iterator it = phiNode->opVerBegin(), eit = phiNode->opVerEnd();
+                it != eit; it++) {
+            const MRVer* op = it->second;
+            NodeID def = getDef(op);
+            collectIndirectSVFGEdge(IndirectEdgeInfo::Intra, def, nodeId, op->getMR()->getPointsTo(), 0, edges);
+        }
+    }
+}
 
+/*!
+ * Collect the indirect edges of every node again on this thread: each node
+ * must have the same edges, in the same order, as collected concurrently.
+ */
+void SVFG::validateParallelTests(const IDToSVFGNodeList& nodes, const std::vector<IndirectEdgeInfos>& edges) {
+    outs() << "[" << pta->PTAName() << "] Checking the indirect SVFG edges found on several threads\n";
+
+    u32_t numOfFailures = 0;
+    for(u32_t i = 0; i < nodes.size(); ++i) {
+        IndirectEdgeInfos expected;
+        collectIndirectSVFGEdges(nodes[i].first, nodes[i].second, &expected);
+        bool same = expected.size() == edges[i].size();
+        for(u32_t e = 0; same && e < expected.size(); ++e) {
+            const IndirectEdgeInfo& lhs = expected[e];
+            const IndirectEdgeInfo& rhs = edges[i][e];
+            same = lhs.kind == rhs.kind && lhs.src == rhs.src && lhs.dst == rhs.dst
+                   && lhs.csId == rhs.csId && lhs.cpts == rhs.cpts;
+        }
+        if (!same && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << "indirect edges of SVFG node " << nodes[i].first << " differ from those found on one thread\n";
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the indirect edges of " << nodes.size() << " SVFG nodes are those found on one thread\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " SVFG nodes have different indirect edges\n";
+}
 
-    connectFromGlobalToProgEntry();
+/*!
+ * Collect an indirect edge, or add it straight away if edges is NULL
+ */
+void SVFG::collectIndirectSVFGEdge(IndirectEdgeInfo::Kind kind, NodeID src, NodeID dst, const PointsTo& cpts,
+                                   CallSiteID csId, IndirectEdgeInfos* edges) {
+    if (edges)
+        edges->push_back(IndirectEdgeInfo(kind, src, dst, cpts, csId));
+    else
+        addIndirectSVFGEdge(kind, src, dst, cpts, csId);
+}
+
+/*!
+ * Add an indirect edge of the given kind
+ */
+void SVFG::addIndirectSVFGEdge(IndirectEdgeInfo::Kind kind, NodeID src, NodeID dst, const PointsTo& cpts, CallSiteID csId) {
+    switch(kind) {
+    case IndirectEdgeInfo::Intra:
+        addIntraIndirectVFEdge(src, dst, cpts);
+        break;
+    case IndirectEdgeInfo::Call:
+        addCallIndirectVFEdge(src, dst, cpts, csId);
+        break;
+    case IndirectEdgeInfo::Ret:
+        addRetIndirectVFEdge(src, dst, cpts, csId);
+        break;
+    }
+}
+
+/*!
+ * The points-to of an inter-procedural indirect edge is what both ends may access
+ */
+bool SVFG::getInterIndirectVFPts(const PointsTo& srcPts, const PointsTo& dstPts, PointsTo& cpts) {
+    if(!srcPts.intersects(dstPts))
+        return false;
+    cpts = srcPts;
+    cpts &= dstPts;
+    return true;
 }
 
 
@@ -325,12 +445,9 @@ SVFGEdge* SVFG::addRetIndirectVFEdge(NodeID srcId, NodeID dstId, const PointsTo&
  *
  */
 SVFGEdge* SVFG::addInterIndirectVFCallEdge(const ActualINSVFGNode* src, const FormalINSVFGNode* dst,CallSiteID csId) {
-    PointsTo cpts1 = src->getPointsTo();
-    PointsTo cpts2 = dst->getPointsTo();
-    if(cpts1.intersects(cpts2)) {
-        cpts1 &= cpts2;
-        return addCallIndirectVFEdge(src->getId(),dst->getId(),cpts1,csId);
-    }
+    PointsTo cpts;
+    if(getInterIndirectVFPts(src->getPointsTo(), dst->getPointsTo(), cpts))
+        return addCallIndirectVFEdge(src->getId(),dst->getId(),cpts,csId);
     return NULL;
 }
 
@@ -338,13 +455,9 @@ SVFGEdge* SVFG::addInterIndirectVFCallEdge(const ActualINSVFGNode* src, const Fo
  * Add inter VF edge from function exit mu to callsite chi
  */
 SVFGEdge* SVFG::addInterIndirectVFRetEdge(const FormalOUTSVFGNode* src, const ActualOUTSVFGNode* dst,CallSiteID csId) {
-
-    PointsTo cpts1 = src->getPointsTo();
-    PointsTo cpts2 = dst->getPointsTo();
-    if(cpts1.intersects(cpts2)) {
-        cpts1 &= cpts2;
-        return addRetIndirectVFEdge(src->getId(),dst->getId(),cpts1,csId);
-    }
+    PointsTo cpts;
+    if(getInterIndirectVFPts(src->getPointsTo(), dst->getPointsTo(), cpts))
+        return addRetIndirectVFEdge(src->getId(),dst->getId(),cpts,csId);
     return NULL;
 }
 
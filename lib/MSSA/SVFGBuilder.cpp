@@ -31,6 +31,7 @@
 #include "MSSA/SVFG.h"
 #include "MSSA/SVFGBuilder.h"
 #include "WPA/Andersen.h"
+#include "Util/Parallel.h"
 
 using namespace SVFUtil;
 
@@ -40,6 +41,12 @@ static llvm::cl::opt<bool> SVFGWithIndirectCall("svfgWithIndCall", llvm::cl::ini
 static llvm::cl::opt<bool> SingleVFG("singleVFG", llvm::cl::init(false),
                                llvm::cl::desc("Create a single VFG shared by multiple analysis"));
 
+static llvm::cl::opt<bool> ParallelMSSA("parallel-mssa", llvm::cl::init(false),
+                               llvm::cl::desc("Build memory SSA of functions on several threads (see -svf-threads)"));
+
+static llvm::cl::opt<bool> CheckParallelMSSA("check-parallel-mssa", llvm::cl::init(false),
+                               llvm::cl::desc("Check the memory SSA built with -parallel-mssa against the one built on a single thread"));
+
 static llvm::cl::opt<bool> OPTSVFG("optSVFG", llvm::cl::init(true),
                                llvm::cl::desc("unoptimized SVFG with formal-in and actual-out"));
 
@@ -120,21 +127,36 @@ MemSSA* SVFGBuilder::buildMSSA(BVDataPTAImpl* pta, bool ptrOnlyMSSA){
 
     MemSSA* mssa = new MemSSA(pta, ptrOnlyMSSA);
 
-    DominatorTree dt;
-    MemSSADF df;
+    u32_t numThreads = ParallelMSSA ? SVFUtil::getNumOfPtsWorkers() : 1;
 
     SVFModule svfModule = mssa->getPTA()->getModule();
-    for (SVFModule::iterator iter = svfModule.begin(), eiter = svfModule.end();
-            iter != eiter; ++iter) {
+    if (numThreads > 1) {
+        std::vector<Function*> funs;
+        for (SVFModule::iterator iter = svfModule.begin(), eiter = svfModule.end();
+                iter != eiter; ++iter) {
+            if (!SVFUtil::isExtCall(*iter))
+                funs.push_back(*iter);
+        }
+        mssa->buildMemSSA(funs, numThreads);
+        if (CheckParallelMSSA)
+            mssa->validateParallelTests(funs);
+    }
+    else {
+        DominatorTree dt;
+        MemSSADF df;
+
+        for (SVFModule::iterator iter = svfModule.begin(), eiter = svfModule.end();
+                iter != eiter; ++iter) {
 
-        Function *fun = *iter;
-        if (SVFUtil::isExtCall(fun))
-            continue;
+            Function *fun = *iter;
+            if (SVFUtil::isExtCall(fun))
+                continue;
 
-        dt.recalculate(*fun);
-        df.runOnDT(dt);
+            dt.recalculate(*fun);
+            df.runOnDT(dt);
 
-        mssa->buildMemSSA(*fun, &df, &dt);
+            mssa->buildMemSSA(*fun, &df, &dt);
+        }
     }
 
     mssa->performStat();
@@ -7,6 +7,7 @@
  *      Author: Mohamad Barbar
  */
 
+#include <functional>
 #include <sstream>
 
 #include "MemoryModel/DCHG.h"
@@ -388,6 +389,12 @@ void DCHGraph::buildCHG(bool extend) {
        finder.processModule(*(svfModule.getModule(i)));
     }
 
+    // Intern all types first, so that later getCanonicalType calls, from here
+    // and from the users of the DCHG, are a single map lookup.
+    for (const DIType *type : finder.types()) {
+        getCanonicalType(type);
+    }
+
     // Create the void node regardless of whether it appears.
     getOrCreateNode(nullptr);
     // Find any char type.
@@ -576,11 +583,25 @@ void DCHGraph::getVFnsFromVtbls(CallSite cs, const VTableSet &vtbls, VFunSet &vi
 bool DCHGraph::isBase(const DIType *a, const DIType *b, bool firstField) {
     a = getCanonicalType(a);
     b = getCanonicalType(b);
-    assert(hasNode(a) && hasNode(b) && "DCHG: isBase query for non-existent node!");
-    const DCHNode *bNode = getNode(b);
+    NodeID aId, bId;
+    bool hasNodes = getCanonicalTypeID(a, aId) && getCanonicalTypeID(b, bId);
+    assert(hasNodes && "DCHG: isBase query for non-existent node!");
+    if (!hasNodes) {
+        // Not memoised: only types with nodes have IDs. A type without a node
+        // is no type's child.
+        const DCHNode *bNode = getNode(b);
+        return bNode != nullptr && cha(a, firstField).test(bNode->getId());
+    }
 
-    const NodeBS &aChildren = cha(a, firstField);
-    return aChildren.test(bNode->getId());
+    DCHTypeRelation &relation = firstField ? baseFFRelation : baseRelation;
+    bool holds;
+    if (relation.lookup(aId, bId, holds)) {
+        return holds;
+    }
+
+    holds = cha(a, firstField).test(bId);
+    relation.set(aId, bId, holds);
+    return holds;
 }
 
 bool DCHGraph::isFieldOf(const DIType *f, const DIType *b) {
@@ -588,6 +609,22 @@ bool DCHGraph::isFieldOf(const DIType *f, const DIType *b) {
 
     f = getCanonicalType(f);
     b = getCanonicalType(b);
+    NodeID fId, bId;
+    if (!getCanonicalTypeID(f, fId) || !getCanonicalTypeID(b, bId)) {
+        return computeIsFieldOf(f, b);
+    }
+
+    bool holds;
+    if (fieldOfRelation.lookup(fId, bId, holds)) {
+        return holds;
+    }
+
+    holds = computeIsFieldOf(f, b);
+    fieldOfRelation.set(fId, bId, holds);
+    return holds;
+}
+
+bool DCHGraph::computeIsFieldOf(const DIType *f, const DIType *b) {
     if (f == b) return true;
 
     if (b->getTag() == dwarf::DW_TAG_array_type || b->getTag() == dwarf::DW_TAG_pointer_type) {
@@ -610,38 +647,88 @@ bool DCHGraph::isFieldOf(const DIType *f, const DIType *b) {
 }
 
 const DIType *DCHGraph::getCanonicalType(const DIType *t) {
+    // Is there a mapping for the unstripped type? Yes - return it.
+    // This is the common case once buildCHG has interned all types.
+    DenseMap<const DIType *, const DIType *>::const_iterator canonIt = canonicalTypeMap.find(t);
+    if (canonIt != canonicalTypeMap.end()) {
+        return canonIt->second;
+    }
+
     // We want stripped types to be canonical.
     const DIType *unstrippedT = t;
     t = stripQualifiers(t);
 
-    // Is there a mapping for the unstripped type? Yes - return it.
-    if (canonicalTypeMap.find(unstrippedT) != canonicalTypeMap.end()) {
-        return canonicalTypeMap[unstrippedT];
-    }
-
     // There is no mapping for unstripped type (^), is there one for the stripped
     // type? Yes - map the unstripped type to the same thing.
     if (unstrippedT != t) {
-        if (canonicalTypeMap.find(t) != canonicalTypeMap.end()) {
-            canonicalTypeMap[unstrippedT] = canonicalTypeMap[t];
-            return canonicalTypeMap[unstrippedT];
+        canonIt = canonicalTypeMap.find(t);
+        if (canonIt != canonicalTypeMap.end()) {
+            const DIType *canonType = canonIt->second;
+            canonicalTypeMap[unstrippedT] = canonType;
+            return canonType;
         }
     }
 
-    // Canonical type for t is not cached, find one for it.
-    for (const DIType *canonType : canonicalTypes) {
+    // Canonical type for t is not cached, find one for it. Only canonical
+    // types with the same hash can be teq to t.
+    std::vector<const DIType *> &bucket = canonicalTypeBuckets[hashType(t)];
+    for (const DIType *canonType : bucket) {
         if (teq(t, canonType)) {
             // Found a canonical type.
             canonicalTypeMap[t] = canonType;
-            return canonicalTypeMap[t];
+            if (unstrippedT != t) canonicalTypeMap[unstrippedT] = canonType;
+            return canonType;
         }
     }
 
     // No canonical type found, so t will be a canonical type.
     canonicalTypes.insert(t);
+    bucket.push_back(t);
     canonicalTypeMap.insert({t, t});
+    if (unstrippedT != t) canonicalTypeMap[unstrippedT] = t;
 
-    return canonicalTypeMap[t];
+    return t;
+}
+
+size_t DCHGraph::hashType(const DIType *t) {
+    t = stripQualifiers(t);
+    if (t == nullptr) {
+        return 0;
+    }
+
+    // Must agree with teq: types which are teq have the same hash.
+    if (const DIBasicType *bt = SVFUtil::dyn_cast<DIBasicType>(t)) {
+        // Signedness is ignored (see teq); other encodings are only equal to themselves.
+        unsigned enc = bt->getEncoding();
+        if (enc == dwarf::DW_ATE_unsigned || enc == dwarf::DW_ATE_boolean) {
+            enc = dwarf::DW_ATE_signed;
+        } else if (enc == dwarf::DW_ATE_unsigned_char) {
+            enc = dwarf::DW_ATE_signed_char;
+        }
+
+        return llvm::hash_combine(1, enc, t->getSizeInBits(), t->getAlignInBits());
+    }
+
+    // Pointers, references, and arrays are equal when their base types are.
+    if (const DIDerivedType *dt = SVFUtil::dyn_cast<DIDerivedType>(t)) {
+        return llvm::hash_combine(2, hashType(dt->getBaseType()));
+    }
+
+    if (const DICompositeType *ct = SVFUtil::dyn_cast<DICompositeType>(t)) {
+        switch (ct->getTag()) {
+        case dwarf::DW_TAG_array_type:
+            return llvm::hash_combine(2, hashType(ct->getBaseType()));
+        case dwarf::DW_TAG_enumeration_type:
+            return llvm::hash_combine(3, ct->getTag());
+        case dwarf::DW_TAG_class_type:
+            return llvm::hash_combine(3, ct->getTag(), ct->getIdentifier());
+        default:
+            return llvm::hash_combine(3, ct->getTag(), ct->getName(), ct->getFile(), ct->getLine());
+        }
+    }
+
+    // Anything else is only equal to itself.
+    return llvm::hash_combine(4, t);
 }
 
 const DIType *DCHGraph::stripQualifiers(const DIType *t) {
@@ -796,15 +883,31 @@ bool DCHGraph::teq(const DIType *t1, const DIType *t2) {
 }
 
 bool DCHGraph::isFirstField(const DIType *f, const DIType *b) {
-    // TODO: some improvements.
-    //   - cha should be changed to accept which edge types to use,
-    //     then we can call cha(..., DCHEdge::FIRST_FIELD).
-    //   - If not ^, this could benefit from caching.
     f = getCanonicalType(f);
     b = getCanonicalType(b);
 
     if (f == b) return true;
 
+    NodeID fId, bId;
+    if (!getCanonicalTypeID(f, fId) || !getCanonicalTypeID(b, bId)) {
+        return computeIsFirstField(f, b);
+    }
+
+    bool holds;
+    if (firstFieldRelation.lookup(fId, bId, holds)) {
+        return holds;
+    }
+
+    holds = computeIsFirstField(f, b);
+    firstFieldRelation.set(fId, bId, holds);
+    return holds;
+}
+
+bool DCHGraph::computeIsFirstField(const DIType *f, const DIType *b) {
+    // TODO: cha should be changed to accept which edge types to use,
+    //       then we can call cha(..., DCHEdge::FIRST_FIELD).
+    if (f == b) return true;
+
     const DCHNode *node = getNode(f);
     assert(node && "DCHG::isFirstField: node not found");
     // Consider oneself a child, otherwise the recursion will just come up with nothing.
@@ -819,6 +922,83 @@ bool DCHGraph::isFirstField(const DIType *f, const DIType *b) {
     return false;
 }
 
+void DCHGraph::validateRelationTests(void) {
+    SVFUtil::outs() << "[DCHG] Checking the memoised type relations\n";
+
+    unsigned numFailures = 0;
+    unsigned numChecked = 0;
+    auto checkRelation = [&](const DCHTypeRelation &relation, const char *name,
+                             std::function<bool(const DIType *, const DIType *)> compute) {
+        for (NodeID a = 0; a < relation.getNumRows(); ++a) {
+            for (NodeID b = 0; b < relation.getRowLength(a); ++b) {
+                bool holds;
+                if (!relation.lookup(a, b, holds)) continue;
+
+                ++numChecked;
+                const DIType *aType = getGNode(a)->getType();
+                const DIType *bType = getGNode(b)->getType();
+                if (compute(aType, bType) != holds && numFailures++ < 10) {
+                    SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << name << "(" << diTypeToStr(aType)
+                                    << ", " << diTypeToStr(bType) << ") is memoised as " << holds << "\n";
+                }
+            }
+        }
+    };
+
+    checkRelation(baseRelation, "isBase", [this](const DIType *a, const DIType *b) {
+        return cha(a, false).test(getNode(b)->getId());
+    });
+    checkRelation(baseFFRelation, "isBase (first field)", [this](const DIType *a, const DIType *b) {
+        return cha(a, true).test(getNode(b)->getId());
+    });
+    checkRelation(firstFieldRelation, "isFirstField", [this](const DIType *f, const DIType *b) {
+        return computeIsFirstField(f, b);
+    });
+    checkRelation(fieldOfRelation, "isFieldOf", [this](const DIType *f, const DIType *b) {
+        return computeIsFieldOf(f, b);
+    });
+
+    if (numFailures == 0) {
+        SVFUtil::outs() << SVFUtil::sucMsg("\t SUCCESS :") << numChecked << " memoised type relations are the computed ones\n";
+    } else {
+        SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << numFailures << " memoised type relations are wrong\n";
+    }
+}
+
+void DCHGraph::validateCanonicalTypeTests(void) {
+    SVFUtil::outs() << "[DCHG] Checking the interned canonical types\n";
+
+    unsigned numFailures = 0;
+    auto check = [&](bool ok, const char *what, const DIType *t) {
+        if (!ok && numFailures++ < 10) {
+            SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << what << " for " << diTypeToStr(t) << "\n";
+        }
+    };
+
+    // The linear search getCanonicalType did: no two canonical types are teq,
+    // whatever their hashes, so the first teq one is the only one.
+    std::vector<const DIType *> canonTypes(canonicalTypes.begin(), canonicalTypes.end());
+    for (size_t i = 0; i < canonTypes.size(); ++i) {
+        for (size_t j = i + 1; j < canonTypes.size(); ++j) {
+            check(!teq(canonTypes[i], canonTypes[j]), "two teq canonical types", canonTypes[i]);
+        }
+    }
+
+    for (const std::pair<const DIType *, const DIType *> &typeCanon : canonicalTypeMap) {
+        const DIType *t = typeCanon.first;
+        const DIType *canonType = typeCanon.second;
+        check(canonicalTypes.count(canonType) && teq(t, canonType), "wrong canonical type", t);
+        check(hashType(t) == hashType(canonType), "hash differing from its canonical type's", t);
+    }
+
+    if (numFailures == 0) {
+        SVFUtil::outs() << SVFUtil::sucMsg("\t SUCCESS :") << canonicalTypeMap.size() << " types map to "
+                        << canonTypes.size() << " canonical types as by a linear search\n";
+    } else {
+        SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << numFailures << " canonical types are wrong\n";
+    }
+}
+
 std::string DCHGraph::diTypeToStr(const DIType *t) {
     std::stringstream ss;
 
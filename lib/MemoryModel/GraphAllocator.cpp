@@ -0,0 +1,128 @@
+//===- GraphAllocator.cpp -- Pooled memory for graph nodes and edges ---------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * GraphAllocator.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "MemoryModel/GraphAllocator.h"
+#include <algorithm>
+#include <set>
+
+/*!
+ * Never destroyed, so that graphs deleted during static destruction can
+ * still free their nodes and edges
+ */
+GraphAllocator& GraphAllocator::getAllocator() {
+    static GraphAllocator* allocator = new GraphAllocator();
+    return *allocator;
+}
+
+/*!
+ * Take an object from the free list of its size class, or bump-allocate
+ * it from the current slab
+ */
+void* GraphAllocator::allocateFromPool(size_t size) {
+    if (size > MaxPooledSize)
+        return ::operator new(size);
+
+    size_t sizeClass = (size + Granule - 1) / Granule;
+    size_t bytes = sizeClass * Granule;
+    numOfLiveObjects++;
+    numOfLiveBytes += bytes;
+    if (FreeObject* obj = freeLists[sizeClass]) {
+        freeLists[sizeClass] = obj->next;
+        return obj;
+    }
+
+    if (cur == NULL || (size_t)(end - cur) < bytes) {
+        cur = static_cast<char*>(::operator new(SlabSize));
+        end = cur + SlabSize;
+        slabs.push_back(cur);
+    }
+    void* obj = cur;
+    cur += bytes;
+    numOfBumpedBytes += bytes;
+    return obj;
+}
+
+/*!
+ * Put an object on the free list of its size class. The slabs are freed
+ * together once the last live object is.
+ */
+void GraphAllocator::deallocateToPool(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return;
+    if (size > MaxPooledSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    assert(numOfLiveObjects > 0 && "freeing more objects than allocated?");
+    size_t sizeClass = (size + Granule - 1) / Granule;
+    FreeObject* obj = static_cast<FreeObject*>(ptr);
+    obj->next = freeLists[sizeClass];
+    freeLists[sizeClass] = obj;
+    numOfLiveBytes -= sizeClass * Granule;
+    if (--numOfLiveObjects == 0)
+        releaseSlabs();
+}
+
+void GraphAllocator::releaseSlabs() {
+    for (std::vector<char*>::const_iterator it = slabs.begin(), eit = slabs.end(); it != eit; ++it)
+        ::operator delete(*it);
+    slabs.clear();
+    std::fill(freeLists.begin(), freeLists.end(), (FreeObject*)NULL);
+    cur = end = NULL;
+    numOfLiveBytes = numOfBumpedBytes = 0;
+}
+
+/*!
+ * Walk the free lists: every free object must lie in a slab and be on a
+ * free list once, and the bumped bytes must be exactly the live and the
+ * free ones.
+ */
+u32_t GraphAllocator::checkPools() const {
+    u32_t numOfErrors = 0;
+    std::set<const FreeObject*> seen;
+    Size_t numOfFreeBytes = 0;
+    for (size_t sizeClass = 0; sizeClass < freeLists.size(); ++sizeClass) {
+        for (const FreeObject* obj = freeLists[sizeClass]; obj != NULL; obj = obj->next) {
+            const char* ptr = reinterpret_cast<const char*>(obj);
+            bool inSlab = false;
+            for (std::vector<char*>::const_iterator it = slabs.begin(), eit = slabs.end(); it != eit && !inSlab; ++it)
+                inSlab = ptr >= *it && ptr + sizeClass * Granule <= *it + SlabSize;
+            if (!inSlab || !seen.insert(obj).second) {
+                // A cycle or a foreign pointer; the rest of the list cannot be trusted.
+                numOfErrors++;
+                break;
+            }
+            numOfFreeBytes += sizeClass * Granule;
+        }
+    }
+
+    if (numOfFreeBytes + numOfLiveBytes != numOfBumpedBytes)
+        numOfErrors++;
+    return numOfErrors;
+}
@@ -520,17 +520,9 @@ LocationSet PAG::getLocationSetFromBaseNode(NodeID nodeId) {
 }
 
 /*!
- * Clean up memory
+ * Clean up memory. Edges are deleted with their destination nodes at GenericGraph.
  */
 void PAG::destroy() {
-    for (PAGEdge::PAGKindToEdgeSetMapTy::iterator I =
-                PAGEdgeKindToSetMap.begin(), E = PAGEdgeKindToSetMap.end(); I != E;
-            ++I) {
-        for (PAGEdge::PAGEdgeSetTy::iterator edgeIt = I->second.begin(),
-                endEdgeIt = I->second.end(); edgeIt != endEdgeIt; ++edgeIt) {
-            delete *edgeIt;
-        }
-    }
     delete symInfo;
     symInfo = NULL;
 }
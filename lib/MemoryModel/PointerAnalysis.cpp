@@ -40,7 +40,11 @@
 #include "MemoryModel/DCHG.h"
 #include "MemoryModel/PTAType.h"
 #include "MemoryModel/ExternalPAG.h"
+#include "MemoryModel/GraphAllocator.h"
 #include "WPA/FlowSensitiveTBHC.h"
+#include <llvm/Support/MathExtras.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SwapByteOrder.h>
 #include <fstream>
 #include <sstream>
 
@@ -86,9 +90,30 @@ static llvm::cl::opt<bool> EnableThreadCallGraph("enable-tcg", llvm::cl::init(tr
 static llvm::cl::opt<bool> INCDFPTData("incdata", llvm::cl::init(true),
                                  llvm::cl::desc("Enable incremental DFPTData for flow-sensitive analysis"));
 
+static llvm::cl::opt<bool> HashConsedDFPTData("hcdata", llvm::cl::init(false),
+                                 llvm::cl::desc("Enable hash-consed (incremental) DFPTData for flow-sensitive analysis"));
+
+static llvm::cl::opt<bool> FlatIndexedDFPTData("flatdata", llvm::cl::init(false),
+                                 llvm::cl::desc("Enable flat, location-indexed (incremental) DFPTData for flow-sensitive analysis"));
+
+static llvm::cl::opt<bool> TextPTAResults("write-ander-text", llvm::cl::init(false),
+                                    llvm::cl::desc("Store pointer analysis results in the text format instead of the binary one"));
+
 static llvm::cl::opt<bool> connectVCallOnCHA("vcall-cha", llvm::cl::init(false),
                                        llvm::cl::desc("connect virtual calls using cha"));
 
+static llvm::cl::opt<bool> CheckPtsRep("check-ptsrep", llvm::cl::init(false),
+                                 llvm::cl::desc("Check every points-to set representation against NodeBS on the final points-to sets"));
+
+static llvm::cl::opt<bool> CheckResultsIO("check-results-io", llvm::cl::init(false),
+                                 llvm::cl::desc("Check the final points-to sets are read back unchanged after storing them in the binary and the text format"));
+
+static llvm::cl::opt<bool> CheckGraphAlloc("check-graph-alloc", llvm::cl::init(false),
+                                 llvm::cl::desc("Check the pools of graph nodes and edges after the analysis"));
+
+static llvm::cl::opt<bool> CheckPointedBy("check-pointed-by", llvm::cl::init(false),
+                                 llvm::cl::desc("Check the pointed-by index against a scan of the final points-to sets of all nodes"));
+
 CommonCHGraph* PointerAnalysis::chgraph = NULL;
 PAG* PointerAnalysis::pag = NULL;
 
@@ -312,6 +337,12 @@ void PointerAnalysis::finalize() {
        && !SVFUtil::isa<FlowSensitiveTBHC>(this))
         validateTests();
 
+    if (BVDataPTAImpl* bvPta = SVFUtil::dyn_cast<BVDataPTAImpl>(this))
+        bvPta->validateBVDataTests();
+
+    if (CheckGraphAlloc)
+        validateGraphAllocTests();
+
     if (!UsePreCompFieldSensitive)
         resetObjFieldSensitive();
 }
@@ -357,13 +388,17 @@ void PointerAnalysis::dumpAllTypes()
  * Constructor
  */
 BVDataPTAImpl::BVDataPTAImpl(PointerAnalysis::PTATY type) :
-		PointerAnalysis(type) {
+		PointerAnalysis(type), pointedByBuilt(false) {
 	if (type == Andersen_WPA || type == AndersenWaveDiff_WPA || type == AndersenHCD_WPA || type == AndersenHLCD_WPA
         || type == AndersenLCD_WPA || type == TypeCPP_WPA || type == FlowS_DDA || type == AndersenWaveDiffWithType_WPA
-        || type == AndersenSCD_WPA || type == AndersenSFR_WPA) {
+        || type == AndersenSCD_WPA || type == AndersenSFR_WPA || type == AndersenWaveDiffParallel_WPA) {
 		ptD = new DiffPTDataTy();
 	} else if (type == FSSPARSE_WPA || type == FSTBHC_WPA || type == FSCS_WPA) {
-		if (INCDFPTData)
+		if (HashConsedDFPTData)
+			ptD = new HCDFPTDataTy();
+		else if (FlatIndexedDFPTData)
+			ptD = new FlatDFPTDataTy();
+		else if (INCDFPTData)
 			ptD = new IncDFPTDataTy();
 		else
 			ptD = new DFPTDataTy();
@@ -385,6 +420,78 @@ void BVDataPTAImpl::expandFIObjs(const PointsTo& pts, PointsTo& expandedPts) {
     }
 }
 
+/*!
+ * Return the nodes whose points-to sets contain obj
+ */
+const NodeBS& BVDataPTAImpl::getPointedBy(NodeID obj) {
+    if (!pointedByBuilt)
+        buildPointedBy();
+
+    static const NodeBS empty;
+    DenseMap<NodeID, NodeBS>::const_iterator it = pointedByMap.find(obj);
+    return it == pointedByMap.end() ? empty : it->second;
+}
+
+/*!
+ * Invert the points-to sets of the points-to map, so that no empty set is
+ * added for nodes which have none. Nodes sharing a points-to set (e.g. the
+ * nodes of an SCC) are grouped first, so each distinct set is only iterated
+ * once.
+ */
+void BVDataPTAImpl::buildPointedBy() {
+    pointedByMap.clear();
+
+    DenseMap<const PointsTo*, NodeBS> ptsToNodes;
+    std::vector<const PointsTo*> ptsOrder;
+    const PTDataTy::PtsMap& ptsMap = ptD->getPtsMap();
+    for (PTDataTy::PtsMapConstIter it = ptsMap.begin(), eit = ptsMap.end(); it != eit; ++it) {
+        // A stale key of a merged node resolves to the set of its rep.
+        const PointsTo* pts = findPts(it->first);
+        if (pts == NULL || pts->empty())
+            continue;
+        DenseMap<const PointsTo*, NodeBS>::iterator nit = ptsToNodes.find(pts);
+        if (nit == ptsToNodes.end()) {
+            nit = ptsToNodes.insert(std::make_pair(pts, NodeBS())).first;
+            ptsOrder.push_back(pts);
+        }
+        getNodesSharingPts(it->first, nit->second);
+    }
+
+    for (const PointsTo* pts : ptsOrder) {
+        const NodeBS& nodes = ptsToNodes[pts];
+        for (PointsTo::iterator pit = pts->begin(), epit = pts->end(); pit != epit; ++pit)
+            pointedByMap[*pit] |= nodes;
+    }
+
+    pointedByBuilt = true;
+}
+
+/// Binary format of stored pointer analysis results. All values are in
+/// host byte order; the magic number doubles as a byte order check, and a
+/// file from a host of the other byte order is rejected.
+///   header:       magic, version, #gep objects, #points-to sets      (u32 each)
+///   gep object:   id, base object (u32), offset (i64)                 sorted by id
+///   points-to:    var, #words (u32), word indices (u32 each),
+///                 words (u64 each)                                    non-zero words only
+static const u32_t PTAResultsMagic = 0x41465653;	// "SVFA"
+static const u32_t PTAResultsVersion = 1;
+
+/// Append value to os in host byte order
+template<typename T>
+static inline void writeBinary(raw_ostream& os, T value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// Read value at cur and move cur past it. Returns false if [cur, end) is too short.
+template<typename T>
+static inline bool readBinary(const char*& cur, const char* end, T& value) {
+    if (static_cast<size_t>(end - cur) < sizeof(T))
+        return false;
+    memcpy(&value, cur, sizeof(T));
+    cur += sizeof(T);
+    return true;
+}
+
 /*!
  * Store pointer analysis result into a file.
  * It includes the points-to relations, and all PAG nodes including those
@@ -401,6 +508,26 @@ void BVDataPTAImpl::writeToFile(const string& filename) {
         return;
     }
 
+    if (TextPTAResults)
+        writeToTextFile(F.os());
+    else
+        writeToBinaryFile(F.os());
+
+    // Job finish and close file
+    F.os().close();
+    if (!F.os().has_error()) {
+        outs() << "\n";
+        F.keep();
+        return;
+    }
+}
+
+/*!
+ * Store pointer analysis result in the text format:
+ * a "var -> { obj1 obj2 }" line per points-to set, then an
+ * "ID baseNodeID offset" line per GepObjPN.
+ */
+void BVDataPTAImpl::writeToTextFile(raw_ostream& os) {
     // Write analysis results to file
     PTDataTy *ptD = getPTDataTy();
     auto &ptsMap = ptD->getPtsMap();
@@ -408,33 +535,77 @@ void BVDataPTAImpl::writeToFile(const string& filename) {
         NodeID var = it->first;
         const PointsTo &pts = getPts(var);
 
-        F.os() << var << " -> { ";
+        os << var << " -> { ";
         if (pts.empty()) {
-            F.os() << " ";
+            os << " ";
         } else {
             for (auto it = pts.begin(), ie = pts.end(); it != ie; ++it) {
-                F.os() << *it << " ";
+                os << *it << " ";
             }
         }
-        F.os() << "}\n";
+        os << "}\n";
     }
 
     // Write GepPAGNodes to file
     for (auto it = pag->begin(), ie = pag->end(); it != ie; ++it) {
         PAGNode* pagNode = it->second;
         if (GepObjPN *gepObjPN = SVFUtil::dyn_cast<GepObjPN>(pagNode)) {
-            F.os() << it->first << " ";
-            F.os() << pag->getBaseObjNode(it->first) << " ";
-            F.os() << gepObjPN->getLocationSet().getOffset() << "\n";
+            os << it->first << " ";
+            os << pag->getBaseObjNode(it->first) << " ";
+            os << gepObjPN->getLocationSet().getOffset() << "\n";
         }
     }
+}
 
-    // Job finish and close file
-    F.os().close();
-    if (!F.os().has_error()) {
-        outs() << "\n";
-        F.keep();
-        return;
+/*!
+ * Store pointer analysis result in the binary format (see PTAResultsMagic).
+ */
+void BVDataPTAImpl::writeToBinaryFile(raw_ostream& os) {
+    // GepObjPNs are recreated in ID order when loading.
+    std::vector<NodeID> gepObjs;
+    for (auto it = pag->begin(), ie = pag->end(); it != ie; ++it) {
+        if (SVFUtil::isa<GepObjPN>(it->second))
+            gepObjs.push_back(it->first);
+    }
+    std::sort(gepObjs.begin(), gepObjs.end());
+
+    PTDataTy *ptD = getPTDataTy();
+    auto &ptsMap = ptD->getPtsMap();
+
+    writeBinary<u32_t>(os, PTAResultsMagic);
+    writeBinary<u32_t>(os, PTAResultsVersion);
+    writeBinary<u32_t>(os, gepObjs.size());
+    writeBinary<u32_t>(os, ptsMap.size());
+
+    for (NodeID id : gepObjs) {
+        const GepObjPN* gepObjPN = SVFUtil::cast<GepObjPN>(pag->getPAGNode(id));
+        writeBinary<u32_t>(os, id);
+        writeBinary<u32_t>(os, pag->getBaseObjNode(id));
+        writeBinary<int64_t>(os, gepObjPN->getLocationSet().getOffset());
+    }
+
+    std::vector<u32_t> wordIndices;
+    std::vector<uint64_t> words;
+    for (auto it = ptsMap.begin(), ie = ptsMap.end(); it != ie; ++it) {
+        wordIndices.clear();
+        words.clear();
+        // Elements are visited in increasing order.
+        const PointsTo &pts = getPts(it->first);
+        for (PointsTo::iterator pit = pts.begin(), pie = pts.end(); pit != pie; ++pit) {
+            u32_t wordIndex = *pit / 64;
+            if (wordIndices.empty() || wordIndices.back() != wordIndex) {
+                wordIndices.push_back(wordIndex);
+                words.push_back(0);
+            }
+            words.back() |= uint64_t(1) << (*pit % 64);
+        }
+
+        writeBinary<u32_t>(os, it->first);
+        writeBinary<u32_t>(os, wordIndices.size());
+        for (u32_t wordIndex : wordIndices)
+            writeBinary<u32_t>(os, wordIndex);
+        for (uint64_t word : words)
+            writeBinary<uint64_t>(os, word);
     }
 }
 
@@ -442,10 +613,66 @@ void BVDataPTAImpl::writeToFile(const string& filename) {
  * Load pointer analysis result form a file.
  * It populates BVDataPTAImpl with the points-to data, and updates PAG with
  * the PAG offset nodes created during Andersen's solving stage.
+ * Both the binary and the text format are accepted. The file is parsed
+ * into temporaries first, so nothing is changed if it cannot be read.
  */
 bool BVDataPTAImpl::readFromFile(const string& filename) {
     outs() << "Loading pointer analysis results from '" << filename << "'...";
 
+    PTDataTy readPtD;
+    StoredGepObjs gepObjs;
+    if (!parseResultsFile(filename, &readPtD, gepObjs))
+        return false;
+
+    // Update points-to sets
+    const PTDataTy::PtsMap& readPtsMap = readPtD.getPtsMap();
+    for (PTDataTy::PtsMapConstIter it = readPtsMap.begin(), eit = readPtsMap.end(); it != eit; ++it)
+        getPTDataTy()->getPts(it->first) = it->second;
+
+    // Update PAG offset nodes
+    for (const StoredGepObj& gepObj : gepObjs) {
+        NodeID n = pag->getGepObjNode(pag->getObject(gepObj.base), LocationSet(gepObj.offset));
+        assert(gepObj.id == n && "Error adding GepObjNode into PAG!");
+    }
+
+    // Update callgraph
+    updateCallGraph(pag->getIndirectCallsites());
+
+    outs() << "\n";
+    return true;
+}
+
+/*!
+ * Parse a file in either format.
+ */
+bool BVDataPTAImpl::parseResultsFile(const string& filename, PTDataTy* ptd, StoredGepObjs& gepObjs) {
+    // Large files are mapped into memory rather than read.
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+        llvm::MemoryBuffer::getFile(filename, -1, false);
+    if (!buffer) {
+        outs() << "  error opening file for reading!\n";
+        return false;
+    }
+
+    const char* begin = (*buffer)->getBufferStart();
+    const char* end = (*buffer)->getBufferEnd();
+    u32_t magic = 0;
+    const char* cur = begin;
+    if (readBinary(cur, end, magic)) {
+        if (magic == PTAResultsMagic)
+            return readFromBinaryFile(begin, end, ptd, gepObjs);
+        if (magic == llvm::sys::getSwappedBytes(PTAResultsMagic)) {
+            outs() << "  binary results written with a different byte order!\n";
+            return false;
+        }
+    }
+    return readFromTextFile(filename, ptd, gepObjs);
+}
+
+/*!
+ * Load pointer analysis result in the text format (see writeToTextFile).
+ */
+bool BVDataPTAImpl::readFromTextFile(const string& filename, PTDataTy* ptd, StoredGepObjs& gepObjs) {
     ifstream F(filename.c_str());
     if (!F.is_open()) {
         outs() << "  error opening file for reading!\n";
@@ -453,7 +680,6 @@ bool BVDataPTAImpl::readFromFile(const string& filename) {
     }
 
     // Read analysis results from file
-    PTDataTy *ptD = getPTDataTy();
     string line;
 
     // Read points-to sets
@@ -468,7 +694,7 @@ bool BVDataPTAImpl::readFromFile(const string& filename) {
 
         // var
         NodeID var = atoi(line.substr(0, pos).c_str());
-        PointsTo &pts = ptD->getPts(var);
+        PointsTo &pts = ptd->getPts(var);
 
         // objs
         pos = pos + delimiter1.length();
@@ -488,22 +714,72 @@ bool BVDataPTAImpl::readFromFile(const string& filename) {
     while (F.good()) {
         // Parse a single line in the form of "ID baseNodeID offset"
         istringstream ss(line);
-        NodeID id;
-        NodeID base;
-        size_t offset;
-        ss >> id >> base >> offset;
-
-        NodeID n = pag->getGepObjNode(pag->getObject(base), LocationSet(offset));
-        assert(id == n && "Error adding GepObjNode into PAG!");
+        StoredGepObj gepObj;
+        ss >> gepObj.id >> gepObj.base >> gepObj.offset;
+        gepObjs.push_back(gepObj);
 
         getline(F, line);
     }
 
-    // Update callgraph
-    updateCallGraph(pag->getIndirectCallsites());
-
     F.close();
-    outs() << "\n";
+    return true;
+}
+
+/*!
+ * Load pointer analysis result in the binary format from [begin, end).
+ */
+bool BVDataPTAImpl::readFromBinaryFile(const char* begin, const char* end, PTDataTy* ptd, StoredGepObjs& gepObjs) {
+    const char* cur = begin;
+    u32_t magic, version, numOfGepObjs, numOfPtsSets;
+    if (!readBinary(cur, end, magic) || !readBinary(cur, end, version)
+            || !readBinary(cur, end, numOfGepObjs) || !readBinary(cur, end, numOfPtsSets)) {
+        outs() << "  truncated file!\n";
+        return false;
+    }
+    if (version != PTAResultsVersion) {
+        outs() << "  unsupported version " << version << "!\n";
+        return false;
+    }
+
+    // Read PAG offset nodes
+    for (u32_t i = 0; i < numOfGepObjs; ++i) {
+        u32_t id, base;
+        int64_t offset;
+        if (!readBinary(cur, end, id) || !readBinary(cur, end, base) || !readBinary(cur, end, offset)) {
+            outs() << "  truncated file!\n";
+            return false;
+        }
+        StoredGepObj gepObj;
+        gepObj.id = id;
+        gepObj.base = base;
+        gepObj.offset = offset;
+        gepObjs.push_back(gepObj);
+    }
+
+    // Read points-to sets
+    for (u32_t i = 0; i < numOfPtsSets; ++i) {
+        u32_t var, numOfWords;
+        if (!readBinary(cur, end, var) || !readBinary(cur, end, numOfWords)
+                || static_cast<size_t>(end - cur) < numOfWords * (sizeof(u32_t) + sizeof(uint64_t))) {
+            outs() << "  truncated file!\n";
+            return false;
+        }
+
+        PointsTo &pts = ptd->getPts(var);
+        const char* wordIndices = cur;
+        const char* words = cur + numOfWords * sizeof(u32_t);
+        for (u32_t w = 0; w < numOfWords; ++w) {
+            u32_t wordIndex;
+            uint64_t word;
+            memcpy(&wordIndex, wordIndices + w * sizeof(u32_t), sizeof(u32_t));
+            memcpy(&word, words + w * sizeof(uint64_t), sizeof(uint64_t));
+            while (word) {
+                pts.set(wordIndex * 64 + llvm::countTrailingZeros(word));
+                word &= word - 1;
+            }
+        }
+        cur = words + numOfWords * sizeof(uint64_t);
+    }
 
     return true;
 }
@@ -561,7 +837,7 @@ void PointerAnalysis::dumpPts(NodeID ptr, const PointsTo& pts) {
 
     outs() << "";
 
-    for (NodeBS::iterator it = pts.begin(), eit = pts.end(); it != eit; ++it) {
+    for (PointsTo::iterator it = pts.begin(), eit = pts.end(); it != eit; ++it) {
         const PAGNode* node = pag->getPAGNode(*it);
         if(SVFUtil::isa<ObjPN>(node) == false)
             continue;
@@ -883,6 +1159,34 @@ void PointerAnalysis::validateExpectedFailureTests(const std::string fun) {
     }
 }
 
+/*!
+ * The pools of GraphAllocator must be consistent, and a freed object must be
+ * handed out again by the next allocation of its size.
+ */
+void PointerAnalysis::validateGraphAllocTests() {
+    outs() << "[" << PTAName() << "] Checking the graph node and edge pools\n";
+
+    u32_t numOfErrors = GraphAllocator::getNumOfPoolErrors();
+    if (numOfErrors != 0)
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfErrors << " inconsistencies in the pools\n";
+
+    const size_t size = 24;
+    void* first = GraphAllocator::allocate(size);
+    void* second = GraphAllocator::allocate(size);
+    GraphAllocator::deallocate(first, size);
+    void* reused = GraphAllocator::allocate(size);
+    if (reused != first) {
+        numOfErrors++;
+        SVFUtil::errs() << errMsg("\t FAIL :") << "a freed object is not reused by the next allocation of its size\n";
+    }
+    GraphAllocator::deallocate(reused, size);
+    GraphAllocator::deallocate(second, size);
+
+    if (numOfErrors == 0)
+        outs() << sucMsg("\t SUCCESS :") << GraphAllocator::getNumOfLiveObjects() << " live objects in "
+               << GraphAllocator::getNumOfSlabs() << " slabs are consistent\n";
+}
+
 /*!
  * Return alias results based on our points-to/alias analysis
  */
@@ -912,12 +1216,214 @@ AliasResult BVDataPTAImpl::alias(NodeID node1, NodeID node2) {
 AliasResult BVDataPTAImpl::alias(const PointsTo& p1, const PointsTo& p2) {
 
     PointsTo pts1;
-    expandFIObjs(p1,pts1);
+    bool hasBlackHole1;
+    expandForAlias(p1,pts1,hasBlackHole1);
     PointsTo pts2;
-    expandFIObjs(p2,pts2);
+    bool hasBlackHole2;
+    expandForAlias(p2,pts2,hasBlackHole2);
+
+    return aliasOfExpanded(pts1,hasBlackHole1,pts2,hasBlackHole2);
+}
+
+/*!
+ * Expand FI objects of pts for alias checking
+ */
+void BVDataPTAImpl::expandForAlias(const PointsTo& pts, PointsTo& expandedPts, bool& hasBlackHole) {
+    expandFIObjs(pts,expandedPts);
+    hasBlackHole = containBlackHoleNode(expandedPts);
+}
+
+/*!
+ * Validate the points-to data structures, each check enabled by its option
+ */
+void BVDataPTAImpl::validateBVDataTests() {
+    if (CheckPtsRep)
+        validatePtsRepTests();
+    if (CheckResultsIO)
+        validateResultsIOTests();
+    if (CheckPointedBy)
+        validatePointedByTests();
+}
+
+/*!
+ * getPointedBy(o) must be the nodes whose points-to set, scanned node by
+ * node, contains o. Every PAG node is queried as an object, so objects
+ * pointed to by no node must get an empty set.
+ */
+void BVDataPTAImpl::validatePointedByTests() {
+    outs() << "[" << PTAName() << "] Checking the pointed-by index\n";
+
+    DenseMap<NodeID, NodeBS> expected;
+    for (PAG::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        const PointsTo& pts = getPts(it->first);
+        for (PointsTo::iterator pit = pts.begin(), epit = pts.end(); pit != epit; ++pit)
+            expected[*pit].set(it->first);
+    }
+
+    static const NodeBS empty;
+    u32_t numOfFailures = 0;
+    for (PAG::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        DenseMap<NodeID, NodeBS>::const_iterator eIt = expected.find(it->first);
+        const NodeBS& nodes = eIt == expected.end() ? empty : eIt->second;
+        const NodeBS& pointedBy = getPointedBy(it->first);
+        if (pointedBy != nodes && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << "<id:" << it->first << "> is pointed by " << pointedBy.count()
+                            << " nodes in the index, " << nodes.count() << " in the points-to sets\n";
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the pointed-by sets of " << pag->getTotalNodeNum() << " nodes match the points-to sets\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " pointed-by sets differ from the points-to sets\n";
+}
+
+/*!
+ * Each pair of consecutive points-to sets of the points-to map, in every
+ * representation (the rhs in the next one, so conversions are covered too),
+ * must give what NodeBS gives for every operation.
+ */
+void BVDataPTAImpl::validatePtsRepTests() {
+    outs() << "[" << PTAName() << "] Checking points-to set representations\n";
+
+    static const PointsTo::Type types[] = { PointsTo::SBV, PointsTo::BV, PointsTo::SV, PointsTo::HCS };
+    static const char* typeNames[] = { "SBV", "BV", "SV", "HCS" };
+    const u32_t numOfTypes = sizeof(types) / sizeof(types[0]);
+
+    u32_t numOfFailures = 0;
+    auto check = [&](bool ok, u32_t t, const char* op, NodeID id) {
+        if (!ok && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << typeNames[t] << " " << op << " on the points-to set of <id:" << id << ">\n";
+    };
+
+    const PTDataTy::PtsMap& ptsMap = ptD->getPtsMap();
+    NodeBS prev;
+    for (PTDataTy::PtsMapConstIter it = ptsMap.begin(), eit = ptsMap.end(); it != eit; ++it) {
+        NodeID id = it->first;
+        NodeBS a = it->second.toNodeBS();
+        const NodeBS& b = prev;
+
+        NodeBS aOrB = a;
+        bool unionChanged = aOrB |= b;
+        NodeBS aAndB = a;
+        bool intersectChanged = aAndB &= b;
+        NodeBS aMinusB = a;
+        bool complementChanged = aMinusB.intersectWithComplement(b);
+
+        for (u32_t t = 0; t < numOfTypes; ++t) {
+            PointsTo pa(types[t]);
+            pa |= a;
+            PointsTo pb(types[(t + 1) % numOfTypes]);
+            pb |= b;
+
+            std::vector<NodeID> elems(pa.begin(), pa.end());
+            check(std::equal(elems.begin(), elems.end(), a.begin()) && elems.size() == a.count(), t, "iteration", id);
+            check(pa.count() == a.count() && pa.empty() == a.empty(), t, "count", id);
+            check(pa.find_first() == a.find_first(), t, "find_first", id);
+            for (NodeID o : b)
+                check(pa.test(o) == a.test(o), t, "test", id);
+            check(pa.toNodeBS() == a, t, "toNodeBS", id);
+            check(pa.contains(pb) == a.contains(b), t, "contains", id);
+            check(pa.intersects(pb) == a.intersects(b), t, "intersects", id);
+            check((pa == pb) == (a == b), t, "==", id);
+
+            PointsTo u(pa);
+            check((u |= pb) == unionChanged && u.toNodeBS() == aOrB, t, "|=", id);
+            PointsTo i(pa);
+            check((i &= pb) == intersectChanged && i.toNodeBS() == aAndB, t, "&=", id);
+            PointsTo c(pa);
+            check(c.intersectWithComplement(pb) == complementChanged && c.toNodeBS() == aMinusB, t, "intersectWithComplement", id);
+            check((pa - pb).toNodeBS() == aMinusB, t, "-", id);
+
+            PointsTo s(types[t]);
+            for (NodeID o : a)
+                check(s.test_and_set(o), t, "test_and_set", id);
+            for (NodeID o : b)
+                s.reset(o);
+            check(s.toNodeBS() == aMinusB, t, "reset", id);
+        }
+
+        prev = a;
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "points-to set representations agree with NodeBS on " << ptsMap.size() << " sets\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " points-to set operations disagree with NodeBS\n";
+}
+
+/*!
+ * Compare the stored results parsed into storedPtD and gepObjs with the
+ * current points-to sets and PAG. Returns the number of differences, the
+ * first few of which are reported as read from source.
+ */
+u32_t BVDataPTAImpl::getNumOfStoredResultsDiffs(const PTDataTy& storedPtD, const StoredGepObjs& gepObjs, const std::string& source) {
+    u32_t numOfDiffs = 0;
+    auto check = [&](bool ok, const char* what, NodeID id) {
+        if (!ok && numOfDiffs++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << what << " <id:" << id << "> differs in " << source << "\n";
+    };
+
+    const PTDataTy::PtsMap& ptsMap = getPTDataTy()->getPtsMap();
+    check(storedPtD.getPtsMap().size() == ptsMap.size(), "number of points-to sets", ptsMap.size());
+    for (PTDataTy::PtsMapConstIter it = ptsMap.begin(), eit = ptsMap.end(); it != eit; ++it) {
+        const PointsTo* storedPts = storedPtD.findPts(it->first);
+        check(storedPts && *storedPts == getPts(it->first), "points-to set", it->first);
+    }
+
+    u32_t numOfGepObjs = 0;
+    for (PAG::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        if (SVFUtil::isa<GepObjPN>(it->second))
+            numOfGepObjs++;
+    }
+    check(gepObjs.size() == numOfGepObjs, "number of gep objects", numOfGepObjs);
+    for (const StoredGepObj& gepObj : gepObjs) {
+        const GepObjPN* gepObjPN = pag->hasGNode(gepObj.id) ? SVFUtil::dyn_cast<GepObjPN>(pag->getPAGNode(gepObj.id)) : NULL;
+        check(gepObjPN && pag->getBaseObjNode(gepObj.id) == gepObj.base
+              && gepObjPN->getLocationSet().getOffset() == gepObj.offset, "gep object", gepObj.id);
+    }
+
+    return numOfDiffs;
+}
+
+/*!
+ * Store the final results in each format to a temporary file and parse it
+ * back: every points-to set and GepObjPN must be read as it was written.
+ */
+void BVDataPTAImpl::validateResultsIOTests() {
+    outs() << "[" << PTAName() << "] Checking stored analysis results are read back unchanged\n";
+
+    u32_t numOfFailures = 0;
+    for (u32_t text = 0; text < 2; ++text) {
+        const char* format = text ? "text" : "binary";
+
+        llvm::SmallString<128> path;
+        int fd;
+        if (llvm::sys::fs::createTemporaryFile("svf-results", "ander", fd, path)) {
+            SVFUtil::errs() << errMsg("\t FAIL :") << "cannot create a temporary file\n";
+            return;
+        }
+        {
+            raw_fd_ostream os(fd, true);
+            if (text)
+                writeToTextFile(os);
+            else
+                writeToBinaryFile(os);
+        }
+
+        PTDataTy readPtD;
+        StoredGepObjs gepObjs;
+        bool parsed = parseResultsFile(path.str().str(), &readPtD, gepObjs);
+        llvm::sys::fs::remove(path);
+        if (!parsed) {
+            numOfFailures++;
+            SVFUtil::errs() << errMsg("\t FAIL :") << "the " << format << " results cannot be parsed\n";
+            continue;
+        }
+        numOfFailures += getNumOfStoredResultsDiffs(readPtD, gepObjs, std::string("the ") + format + " results");
+    }
 
-    if (containBlackHoleNode(pts1) || containBlackHoleNode(pts2) || pts1.intersects(pts2))
-        return llvm::MayAlias;
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << getPTDataTy()->getPtsMap().size() << " points-to sets and their gep objects are read back in both formats\n";
     else
-        return llvm::NoAlias;
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " stored results are not read back unchanged\n";
 }
@@ -41,6 +41,7 @@ using namespace SVFUtil;
  * Guard(path_i) = \bigwedge VFGGuard(x,y),  suppose (x,y) are two SVFGNode nodes on path_i
  */
 void ProgSlice::AllPathReachableSolve() {
+    CondScope scope(pathAllocator, conds);
     const SVFGNode* source = getSource();
     VFWorkList worklist;
     worklist.push(source);
@@ -86,6 +87,7 @@ void ProgSlice::AllPathReachableSolve() {
  * Solve by computing disjunction of conditions from all sinks (e.g., memory leak)
  */
 bool ProgSlice::isSatisfiableForAll() {
+    CondScope scope(pathAllocator, conds);
 
     Condition* guard = getFalseCond();
     for(SVFGNodeSetIter it = sinksBegin(), eit = sinksEnd(); it!=eit; ++it) {
@@ -100,6 +102,7 @@ bool ProgSlice::isSatisfiableForAll() {
  * Solve by analysing each pair of sinks (e.g., double free)
  */
 bool ProgSlice::isSatisfiableForPairs() {
+    CondScope scope(pathAllocator, conds);
 
     for(SVFGNodeSetIter it = sinksBegin(), eit = sinksEnd(); it!=eit; ++it) {
         for(SVFGNodeSetIter sit = it, esit = sinksEnd(); sit!=esit; ++sit) {
@@ -208,12 +211,10 @@ void ProgSlice::annotatePaths() {
 }
 
 
+/*!
+ * Release the conditions created for this slice. Those referenced by
+ * svfgNodeToCondMap and finalCond are dead from now on.
+ */
 void ProgSlice::destroy() {
-    /// TODO: how to clean bdd memory
-//	for(SVFGNodeToCondMap::const_iterator it = svfgNodeToCondMap.begin(), eit = svfgNodeToCondMap.end(); it!=eit; ++it){
-//		pathAllocator->markForRelease(it->second);
-//	}
-//	for(BBToCondMap::const_iterator it = bbToCondMap.begin(), eit = bbToCondMap.end(); it!=eit; ++it){
-//		pathAllocator->markForRelease(it->second);
-//	}
+    pathAllocator->releaseConds(conds);
 }
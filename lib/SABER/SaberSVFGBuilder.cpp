@@ -92,11 +92,11 @@ NodeBS& SaberSVFGBuilder::CollectPtsChain(BVDataPTAImpl* pta,NodeID id, NodeToPT
     if(it!=cachedPtsMap.end())
         return it->second;
     else {
-        PointsTo& pts = cachedPtsMap[baseId];
+        NodeBS& pts = cachedPtsMap[baseId];
         pts |= pag->getFieldsAfterCollapse(baseId);
 
         WorkList worklist;
-        for(PointsTo::iterator it = pts.begin(), eit = pts.end(); it!=eit; ++it)
+        for(NodeBS::iterator it = pts.begin(), eit = pts.end(); it!=eit; ++it)
             worklist.push(*it);
 
         while(!worklist.empty()) {
@@ -117,10 +117,15 @@ NodeBS& SaberSVFGBuilder::CollectPtsChain(BVDataPTAImpl* pta,NodeID id, NodeToPT
 bool SaberSVFGBuilder::accessGlobal(BVDataPTAImpl* pta,const PAGNode* pagNode) {
 
     NodeID id = pagNode->getId();
-    PointsTo pts = pta->getPts(id);
-    pts.set(id);
+    if(globs.test(id))
+        return true;
 
-    return pts.intersects(globs);
+    const PointsTo& pts = pta->getPts(id);
+    for(PointsTo::iterator it = pts.begin(), eit = pts.end(); it!=eit; ++it) {
+        if(globs.test(*it))
+            return true;
+    }
+    return false;
 }
 
 void SaberSVFGBuilder::rmDerefDirSVFGEdges(BVDataPTAImpl* pta) {
@@ -30,6 +30,8 @@
 
 #include "SABER/SrcSnkDDA.h"
 #include "MSSA/SVFGStat.h"
+#include "Util/Parallel.h"
+#include <algorithm>
 
 using namespace SVFUtil;
 
@@ -39,12 +41,121 @@ static llvm::cl::opt<bool> DumpSlice("dump-slice", llvm::cl::init(false),
 static llvm::cl::opt<unsigned> cxtLimit("cxtlimit",  llvm::cl::init(3),
                                   llvm::cl::desc("Source-Sink Analysis Contexts Limit"));
 
+static llvm::cl::opt<bool> SaberParallel("saber-parallel", llvm::cl::init(false),
+                               llvm::cl::desc("Compute the slices of different sources on several threads (-svf-threads)"));
+
+static llvm::cl::opt<bool> SaberCheckParallel("saber-check-parallel", llvm::cl::init(false),
+                               llvm::cl::desc("Check the slices computed by -saber-parallel against the sequential traversal"));
+
+static llvm::cl::opt<bool> SaberSummary("saber-summary", llvm::cl::init(false),
+                               llvm::cl::desc("Reuse callee reachability summaries across slices instead of traversing callees"));
+
+static llvm::cl::opt<bool> SaberCheckSummary("saber-check-summary", llvm::cl::init(false),
+                               llvm::cl::desc("Check the slices computed with -saber-summary against traversing the callees"));
+
+/*!
+ * Call site of a call or return edge
+ */
+static CallSiteID getCallSiteId(const SVFGEdge* edge) {
+    if (const CallDirSVFGEdge* callEdge = SVFUtil::dyn_cast<CallDirSVFGEdge>(edge))
+        return callEdge->getCallSiteId();
+    else if (const CallIndSVFGEdge* callEdge = SVFUtil::dyn_cast<CallIndSVFGEdge>(edge))
+        return callEdge->getCallSiteId();
+    else if (const RetDirSVFGEdge* retEdge = SVFUtil::dyn_cast<RetDirSVFGEdge>(edge))
+        return retEdge->getCallSiteId();
+    else
+        return SVFUtil::cast<RetIndSVFGEdge>(edge)->getCallSiteId();
+}
+
+/*!
+ * The nodes reached in a callee from an entry node (the destination of a
+ * call edge) with balanced calls and returns, and the return edges through
+ * which the value flows back to its callers. The nodes of the callees it
+ * enters in turn are kept in their own summaries.
+ */
+struct SrcSnkDDA::CalleeSummary {
+    CalleeSummary(NodeID e): entry(e), reachGlobal(false) {}
+
+    NodeID entry;
+    std::vector<const SVFGNode*> nodes;	///< nodes reached in the callee
+    std::vector<const SVFGNode*> sinks;	///< the sinks among nodes
+    std::vector<const CalleeSummary*> callees;	///< summaries of the callees entered
+    std::vector<const SVFGEdge*> exits;	///< return edges out of the callee
+    bool reachGlobal;	///< whether a global is reached, in which case the rest is partial
+};
+
+/*!
+ * The forward and backward traversals of SrcSnkDDA, on one slice with their
+ * own worklist and visited sets
+ */
+class SrcSnkDDA::SliceSolver : public CFLSrcSnkSolver {
+public:
+    SliceSolver(SrcSnkDDA* a, ProgSlice* s): dda(a), slice(s) {
+        setGraph(const_cast<SVFG*>(dda->getSVFG()));
+    }
+
+    /// Compute the forward slice of the source, and the backward slice from
+    /// the sinks reached unless the source reaches globals
+    void solve() {
+        ContextCond cxt;
+        DPIm item(slice->getSource()->getId(), cxt);
+        forwardTraverse(item);
+        if (slice->isReachGlobal())
+            return;
+
+        for (SVFGNodeSetIter sit = slice->sinksBegin(), esit = slice->sinksEnd(); sit != esit; ++sit) {
+            ContextCond cxt;
+            DPIm item((*sit)->getId(), cxt);
+            backwardTraverse(item);
+        }
+    }
+
+protected:
+    virtual void forwardProcess(const DPIm& item) {
+        dda->processForward(slice, getNode(item.getCurNodeID()));
+    }
+    virtual void backwardProcess(const DPIm& item) {
+        dda->processBackward(slice, getNode(item.getCurNodeID()));
+    }
+    virtual void forwardpropagate(const DPIm& item, SVFGEdge* edge) {
+        DPImVector newItems;
+        if (dda->propagateThroughCallee(slice, nodeToDPItemsMap, summarisedEntries, edge, item, newItems)) {
+            for (DPImVector::iterator it = newItems.begin(), eit = newItems.end(); it != eit; ++it)
+                pushIntoWorklist(*it);
+            return;
+        }
+        DPIm newItem(edge->getDstID(), item.getContexts());
+        if (dda->propagateForward(slice, nodeToDPItemsMap, edge, newItem))
+            pushIntoWorklist(newItem);
+    }
+    virtual void backwardpropagate(const DPIm& item, SVFGEdge* edge) {
+        if (dda->propagateBackward(visitedSet, edge)) {
+            ContextCond cxt;
+            DPIm newItem(edge->getSrcID(), cxt);
+            pushIntoWorklist(newItem);
+        }
+    }
+
+private:
+    SrcSnkDDA* dda;
+    ProgSlice* slice;
+    SVFGNodeToDPItemsMap nodeToDPItemsMap;	///<  record forward visited dpitems
+    SVFGNodeSet visitedSet;	///<  record backward visited nodes
+    NodeBS summarisedEntries;	///< entry nodes whose summaries were applied
+};
+
 void SrcSnkDDA::analyze(SVFModule module) {
 
     initialize(module);
 
     ContextCond::setMaxCxtLen(cxtLimit);
 
+    if (SaberParallel && getNumOfThreads() > 1) {
+        analyzeInParallel();
+        finalize();
+        return;
+    }
+
     for (SVFGNodeSetIter iter = sourcesBegin(), eiter = sourcesEnd();
             iter != eiter; ++iter) {
         setCurSlice(*iter);
@@ -76,6 +187,14 @@ void SrcSnkDDA::analyze(SVFModule module) {
             DBOUT(DSaber, outs() << "Guard computation for slice:" << (*iter)->getId() << ")\n");
         }
 
+        if (SaberSummary && SaberCheckSummary) {
+            ProgSlice* slice = _curSlice;
+            _curSlice = NULL;
+            checkSummarySlice(slice);
+            delete _curSlice;
+            _curSlice = slice;
+        }
+
         reportBug(getCurSlice());
     }
 
@@ -83,79 +202,410 @@ void SrcSnkDDA::analyze(SVFModule module) {
 }
 
 
+/*!
+ * Slices are computed in batches, so that only a batch of them is in memory
+ * at a time. Guards are computed and bugs reported on the calling thread,
+ * as the path conditions are not thread-safe.
+ */
+void SrcSnkDDA::analyzeInParallel() {
+    std::vector<const SVFGNode*> srcs(sourcesBegin(), sourcesEnd());
+    const u32_t batchSize = getNumOfThreads() * 64;
+    std::vector<ProgSlice*> slices;
+    u32_t numOfSliceDiffs = 0;
+    for (u32_t begin = 0; begin < srcs.size(); begin += batchSize) {
+        u32_t end = std::min<u32_t>(begin + batchSize, srcs.size());
+        slices.assign(end - begin, NULL);
+        for (u32_t i = begin; i < end; ++i)
+            slices[i - begin] = new ProgSlice(srcs[i], getPathAllocator(), getSVFG());
+
+        parallelFor(begin, end, [&](u32_t i) {
+            SliceSolver solver(this, slices[i - begin]);
+            solver.solve();
+        }, getNumOfThreads(), 1);
+
+        for (u32_t i = begin; i < end; ++i) {
+            if (SaberCheckParallel)
+                numOfSliceDiffs += getNumOfSliceDiffs(slices[i - begin]);
+            if (SaberSummary && SaberCheckSummary)
+                checkSummarySlice(slices[i - begin]);
+
+            if(_curSlice!=NULL)
+                delete _curSlice;
+            _curSlice = slices[i - begin];
+
+            DBOUT(DGENERAL, outs() << "Analysing slice:" << srcs[i]->getId() << ")\n");
+            if (!getCurSlice()->isReachGlobal())
+                AllPathReachability();
+            reportBug(getCurSlice());
+        }
+    }
+
+    if (SaberCheckParallel) {
+        outs() << "[SABER] Checking the slices of " << srcs.size() << " sources computed on " << getNumOfThreads() << " threads\n";
+        if (numOfSliceDiffs == 0)
+            outs() << sucMsg("\t SUCCESS :") << "the slices are the ones of the sequential traversal\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << numOfSliceDiffs << " slice differences with the sequential traversal\n";
+    }
+}
+
+/*!
+ * Recompute the slice of the source of slice as the sequential analysis
+ * does, as the current slice, and compare the two before guards are computed
+ */
+u32_t SrcSnkDDA::getNumOfSliceDiffs(const ProgSlice* slice) {
+    const SVFGNode* src = slice->getSource();
+    computeCurSlice(src);
+
+    const ProgSlice* seq = getCurSlice();
+    u32_t numOfDiffs = 0;
+    auto check = [&](bool ok, const char* what) {
+        if (!ok && numOfDiffs++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << what << " of the slice of source " << src->getId() << " differs\n";
+    };
+    check(slice->getForwardSliceSize() == seq->getForwardSliceSize()
+          && std::equal(slice->forwardSliceBegin(), slice->forwardSliceEnd(), seq->forwardSliceBegin()), "forward slice");
+    check(slice->getBackwardSliceSize() == seq->getBackwardSliceSize()
+          && std::equal(slice->backwardSliceBegin(), slice->backwardSliceEnd(), seq->backwardSliceBegin()), "backward slice");
+    check(slice->getSinks() == seq->getSinks(), "sinks");
+    check(slice->isReachGlobal() == seq->isReachGlobal(), "reaching globals");
+    check(slice->isPartialReachable() == seq->isPartialReachable(), "partial reachability");
+    return numOfDiffs;
+}
+
+/*!
+ * Compute the slice of src with the sequential traversal, replacing the
+ * current slice (which must not be one the caller still uses)
+ */
+void SrcSnkDDA::computeCurSlice(const SVFGNode* src) {
+    setCurSlice(src);
+    clearVisitedMap();
+    ContextCond cxt;
+    DPIm item(src->getId(), cxt);
+    forwardTraverse(item);
+    if (!getCurSlice()->isReachGlobal()) {
+        for (SVFGNodeSetIter sit = getCurSlice()->sinksBegin(), esit = getCurSlice()->sinksEnd(); sit != esit; ++sit) {
+            ContextCond cxt;
+            DPIm item((*sit)->getId(), cxt);
+            backwardTraverse(item);
+        }
+    }
+}
+
+/*!
+ * Recompute the slice of the source of slice by traversing callees, as the
+ * current slice. Summaries are as precise as the traversal where contexts
+ * are not truncated by -cxtlimit and more precise where they are, so what
+ * the summarised slice reaches must be reached by the traversal too. Slices
+ * reaching globals are partial and not compared.
+ */
+void SrcSnkDDA::checkSummarySlice(const ProgSlice* slice) {
+    traverseCallees = true;
+    computeCurSlice(slice->getSource());
+    traverseCallees = false;
+
+    const ProgSlice* plain = getCurSlice();
+    numOfSummaryChecks++;
+    if (plain->isReachGlobal())
+        return;
+
+    bool ok = !slice->isReachGlobal()
+              && std::includes(plain->forwardSliceBegin(), plain->forwardSliceEnd(), slice->forwardSliceBegin(), slice->forwardSliceEnd())
+              && std::includes(plain->sinksBegin(), plain->sinksEnd(), slice->sinksBegin(), slice->sinksEnd());
+    if (!ok) {
+        if (numOfSummaryDiffs++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << "the summarised slice of source " << slice->getSource()->getId()
+                            << " reaches what traversing the callees does not\n";
+    }
+    else if (slice->getForwardSliceSize() < plain->getForwardSliceSize())
+        numOfSmallerSummarySlices++;
+}
+
+/*!
+ * Report the checks of the summarised slices (-saber-check-summary)
+ */
+void SrcSnkDDA::validateSummaryTests() {
+    if (!SaberSummary || !SaberCheckSummary)
+        return;
+
+    outs() << "[SABER] Checking " << numOfSummaryChecks << " slices computed with callee summaries\n";
+    if (numOfSummaryDiffs == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the slices are within the ones of traversing the callees ("
+               << numOfSmallerSummarySlices << " smaller, as no context is truncated)\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfSummaryDiffs << " slices reach what traversing the callees does not\n";
+}
+
 /*!
  * Propagate information forward by matching context
  */
 void SrcSnkDDA::forwardpropagate(const DPIm& item, SVFGEdge* edge) {
-    DBOUT(DSaber,outs() << "\n##processing source: " << getCurSlice()->getSource()->getId() <<" forward propagate from (" << edge->getSrcID());
+    DPImVector newItems;
+    if (propagateThroughCallee(_curSlice, nodeToDPItemsMap, summarisedEntries, edge, item, newItems)) {
+        for (DPImVector::iterator it = newItems.begin(), eit = newItems.end(); it != eit; ++it)
+            pushIntoWorklist(*it);
+        return;
+    }
+    DPIm newItem(edge->getDstID(), item.getContexts());
+    if (propagateForward(_curSlice, nodeToDPItemsMap, edge, newItem))
+        pushIntoWorklist(newItem);
+}
+
+/*!
+ * Propagate information backward without matching context, as forward analysis already did it
+ */
+void SrcSnkDDA::backwardpropagate(const DPIm& item, SVFGEdge* edge) {
+    if (propagateBackward(visitedSet, edge)) {
+        ContextCond cxt;
+        DPIm newItem(edge->getSrcID(), cxt);
+        pushIntoWorklist(newItem);
+    }
+}
+
+/*!
+ * Add a node reached forward to the slice, as a sink or otherwise
+ */
+void SrcSnkDDA::processForward(ProgSlice* slice, const SVFGNode* node) {
+    if(isSink(node)) {
+        slice->addToSinks(node);
+        slice->addToForwardSlice(node);
+        slice->setPartialReachable();
+    }
+    else
+        slice->addToForwardSlice(node);
+}
+
+/*!
+ * Add a node reached backward to the slice if it is on the forward slice
+ */
+void SrcSnkDDA::processBackward(ProgSlice* slice, const SVFGNode* node) {
+    if(slice->inForwardSlice(node)) {
+        slice->addToBackwardSlice(node);
+    }
+}
+
+/*!
+ * Match the context of newItem along edge and mark it visited
+ */
+bool SrcSnkDDA::propagateForward(ProgSlice* slice, SVFGNodeToDPItemsMap& visited, SVFGEdge* edge, DPIm& newItem) {
+    DBOUT(DSaber,outs() << "\n##processing source: " << slice->getSource()->getId() <<" forward propagate from (" << edge->getSrcID());
 
     // for indirect SVFGEdge, the propagation should follow the def-use chains
     // points-to on the edge indicate whether the object of source node can be propagated
 
     const SVFGNode* dstNode = edge->getDstNode();
-    DPIm newItem(dstNode->getId(),item.getContexts());
 
     /// handle globals here
-    if(isGlobalSVFGNode(dstNode) || getCurSlice()->isReachGlobal()) {
-        getCurSlice()->setReachGlobal();
-        return;
+    if(isGlobalSVFGNode(dstNode) || slice->isReachGlobal()) {
+        slice->setReachGlobal();
+        return false;
     }
 
 
     /// perform context sensitive reachability
     // push context for calling
     if (edge->isCallVFGEdge()) {
-        CallSiteID csId = 0;
-        if(const CallDirSVFGEdge* callEdge = SVFUtil::dyn_cast<CallDirSVFGEdge>(edge))
-            csId = callEdge->getCallSiteId();
-        else
-            csId = SVFUtil::cast<CallIndSVFGEdge>(edge)->getCallSiteId();
+        CallSiteID csId = getCallSiteId(edge);
 
         newItem.pushContext(csId);
         DBOUT(DSaber, outs() << " push cxt [" << csId << "] ");
     }
     // match context for return
     else if (edge->isRetVFGEdge()) {
-        CallSiteID csId = 0;
-        if(const RetDirSVFGEdge* callEdge = SVFUtil::dyn_cast<RetDirSVFGEdge>(edge))
-            csId = callEdge->getCallSiteId();
-        else
-            csId = SVFUtil::cast<RetIndSVFGEdge>(edge)->getCallSiteId();
+        CallSiteID csId = getCallSiteId(edge);
 
         if (newItem.matchContext(csId) == false) {
             DBOUT(DSaber, outs() << "-|-\n");
-            return;
+            return false;
         }
         DBOUT(DSaber, outs() << " pop cxt [" << csId << "] ");
     }
 
     /// whether this dstNode has been visited or not
-    if(forwardVisited(dstNode,newItem)) {
+    if(visited[dstNode].insert(newItem).second == false) {
         DBOUT(DSaber,outs() << " node "<< dstNode->getId() <<" has been visited\n");
-        return;
+        return false;
     }
-    else
-        addForwardVisited(dstNode, newItem);
-
-    if(pushIntoWorklist(newItem))
-        DBOUT(DSaber,outs() << " --> " << edge->getDstID() << ", cxt size: " << newItem.getContexts().cxtSize() <<")\n");
 
+    DBOUT(DSaber,outs() << " --> " << edge->getDstID() << ", cxt size: " << newItem.getContexts().cxtSize() <<")\n");
+    return true;
 }
 
 /*!
- * Propagate information backward without matching context, as forward analysis already did it
+ * Mark the source of edge visited
  */
-void SrcSnkDDA::backwardpropagate(const DPIm& item, SVFGEdge* edge) {
+bool SrcSnkDDA::propagateBackward(SVFGNodeSet& visited, SVFGEdge* edge) {
     DBOUT(DSaber,outs() << "backward propagate from (" << edge->getDstID() << " --> " << edge->getSrcID() << ")\n");
-    const SVFGNode* srcNode = edge->getSrcNode();
-    if(backwardVisited(srcNode))
-        return;
-    else
-        addBackwardVisited(srcNode);
+    return visited.insert(edge->getSrcNode()).second;
+}
+
+/*!
+ * Apply the summary of the callee entered by a call edge to the slice, and
+ * continue in the caller from the return edges of the same call site, with
+ * the context of the caller unchanged
+ */
+bool SrcSnkDDA::propagateThroughCallee(ProgSlice* slice, SVFGNodeToDPItemsMap& visited, NodeBS& summarised,
+                                       SVFGEdge* edge, const DPIm& item, DPImVector& newItems) {
+    if (!SaberSummary || traverseCallees || !edge->isCallVFGEdge())
+        return false;
+    const SVFGNode* entry = edge->getDstNode();
+    if (isGlobalSVFGNode(entry) || slice->isReachGlobal())
+        return false;
+
+    SVFGNodeSet inProgress;
+    const CalleeSummary* summary = getCalleeSummary(entry, inProgress);
+    applyCalleeSummary(slice, summarised, summary);
+    if (slice->isReachGlobal())
+        return true;
+
+    CallSiteID csId = getCallSiteId(edge);
+    for (std::vector<const SVFGEdge*>::const_iterator it = summary->exits.begin(), eit = summary->exits.end(); it != eit; ++it) {
+        const SVFGEdge* retEdge = *it;
+        if (getCallSiteId(retEdge) != csId)
+            continue;
+        const SVFGNode* dstNode = retEdge->getDstNode();
+        if (isGlobalSVFGNode(dstNode)) {
+            slice->setReachGlobal();
+            return true;
+        }
+        DPIm newItem(retEdge->getDstID(), item.getContexts());
+        if (visited[dstNode].insert(newItem).second)
+            newItems.push_back(newItem);
+    }
+    return true;
+}
+
+/*!
+ * Get the summary of an entry node, computing it if no slice did so far.
+ * Summaries being computed by this thread are in inProgress.
+ */
+const SrcSnkDDA::CalleeSummary* SrcSnkDDA::getCalleeSummary(const SVFGNode* entry, SVFGNodeSet& inProgress) {
+    {
+        std::lock_guard<std::mutex> lock(calleeSummaryMutex);
+        CalleeSummaryMap::const_iterator it = calleeSummaries.find(entry);
+        if (it != calleeSummaries.end())
+            return it->second;
+    }
+
+    // Computed without the lock, which another thread may have done meanwhile
+    CalleeSummary* summary = computeCalleeSummary(entry, inProgress);
+    std::lock_guard<std::mutex> lock(calleeSummaryMutex);
+    std::pair<CalleeSummaryMap::iterator, bool> res = calleeSummaries.insert(std::make_pair(entry, summary));
+    if (res.second == false)
+        delete summary;
+    return res.first->second;
+}
 
+/*!
+ * Traverse the callee from its entry node as a slice would from an empty
+ * context. Return edges taken with an empty context leave the callee and are
+ * recorded as exits. Callees entered in turn are summarised too, except
+ * those being summarised (recursion), which are traversed.
+ */
+SrcSnkDDA::CalleeSummary* SrcSnkDDA::computeCalleeSummary(const SVFGNode* entry, SVFGNodeSet& inProgress) {
+    CalleeSummary* summary = new CalleeSummary(entry->getId());
+    inProgress.insert(entry);
+
+    SVFGNodeToDPItemsMap visited;
+    FIFOWorkList<DPIm> worklist;
+    NodeBS reached;
     ContextCond cxt;
-    DPIm newItem(srcNode->getId(), cxt);
-    pushIntoWorklist(newItem);
+    DPIm start(entry->getId(), cxt);
+    visited[entry].insert(start);
+    worklist.push(start);
+
+    while (!worklist.empty() && !summary->reachGlobal) {
+        DPIm item = worklist.pop();
+        const SVFGNode* node = getSVFG()->getSVFGNode(item.getCurNodeID());
+        if (reached.test_and_set(node->getId())) {
+            summary->nodes.push_back(node);
+            if (isSink(node))
+                summary->sinks.push_back(node);
+        }
+
+        for (SVFGNode::const_iterator it = node->OutEdgeBegin(), eit = node->OutEdgeEnd(); it != eit; ++it) {
+            const SVFGEdge* edge = *it;
+            const SVFGNode* dstNode = edge->getDstNode();
+            if (isGlobalSVFGNode(dstNode)) {
+                summary->reachGlobal = true;
+                break;
+            }
+
+            DPIm newItem(edge->getDstID(), item.getContexts());
+            if (edge->isCallVFGEdge()) {
+                CallSiteID csId = getCallSiteId(edge);
+                if (inProgress.find(dstNode) == inProgress.end()) {
+                    const CalleeSummary* callee = getCalleeSummary(dstNode, inProgress);
+                    summary->callees.push_back(callee);
+                    if (callee->reachGlobal) {
+                        summary->reachGlobal = true;
+                        break;
+                    }
+                    for (std::vector<const SVFGEdge*>::const_iterator xit = callee->exits.begin(), exeit = callee->exits.end(); xit != exeit; ++xit) {
+                        if (getCallSiteId(*xit) != csId)
+                            continue;
+                        const SVFGNode* retNode = (*xit)->getDstNode();
+                        if (isGlobalSVFGNode(retNode)) {
+                            summary->reachGlobal = true;
+                            break;
+                        }
+                        DPIm retItem((*xit)->getDstID(), item.getContexts());
+                        if (visited[retNode].insert(retItem).second)
+                            worklist.push(retItem);
+                    }
+                    if (summary->reachGlobal)
+                        break;
+                    continue;
+                }
+                newItem.pushContext(csId);
+            }
+            else if (edge->isRetVFGEdge()) {
+                if (item.getContexts().cxtSize() == 0) {
+                    summary->exits.push_back(edge);
+                    continue;
+                }
+                if (newItem.matchContext(getCallSiteId(edge)) == false)
+                    continue;
+            }
+
+            if (visited[dstNode].insert(newItem).second)
+                worklist.push(newItem);
+        }
+    }
+
+    inProgress.erase(entry);
+    return summary;
+}
+
+/*!
+ * Add the nodes and sinks of a summary and of the callees it enters to the
+ * slice, each summary once per slice
+ */
+void SrcSnkDDA::applyCalleeSummary(ProgSlice* slice, NodeBS& summarised, const CalleeSummary* summary) {
+    std::vector<const CalleeSummary*> worklist;
+    worklist.push_back(summary);
+    while (!worklist.empty()) {
+        const CalleeSummary* cur = worklist.back();
+        worklist.pop_back();
+        if (!summarised.test_and_set(cur->entry))
+            continue;
+        if (cur->reachGlobal)
+            slice->setReachGlobal();
+
+        for (std::vector<const SVFGNode*>::const_iterator it = cur->nodes.begin(), eit = cur->nodes.end(); it != eit; ++it)
+            slice->addToForwardSlice(*it);
+        for (std::vector<const SVFGNode*>::const_iterator it = cur->sinks.begin(), eit = cur->sinks.end(); it != eit; ++it) {
+            slice->addToSinks(*it);
+            slice->setPartialReachable();
+        }
+        worklist.insert(worklist.end(), cur->callees.begin(), cur->callees.end());
+    }
+}
+
+void SrcSnkDDA::releaseCalleeSummaries() {
+    for (CalleeSummaryMap::iterator it = calleeSummaries.begin(), eit = calleeSummaries.end(); it != eit; ++it)
+        delete it->second;
+    calleeSummaries.clear();
 }
 
 /// Guarded reachability search
@@ -202,4 +652,6 @@ void SrcSnkDDA::printBDDStat() {
     outs() << "BDD Mem usage: " << PathCondAllocator::getMemUsage() << "\n";
     outs() << "BDD Number: " << PathCondAllocator::getCondNum() << "\n";
     outs() << "BDD max live number: " << PathCondAllocator::getMaxLiveCondNumber() << "\n";
+    outs() << "Guard cache hits/misses: " << getPathAllocator()->getNumOfGuardCacheHits()
+           << "/" << getPathAllocator()->getNumOfGuardCacheMisses() << "\n";
 }
@@ -53,6 +53,7 @@ DdNode* BddCondManager::AND(DdNode* lhs, DdNode* rhs) {
         }
         else {
             Cudd_Ref(tmp);
+            addToRefScope(tmp);
             return tmp;
         }
     }
@@ -77,6 +78,7 @@ DdNode* BddCondManager::OR(DdNode* lhs, DdNode* rhs) {
         }
         else {
             Cudd_Ref(tmp);
+            addToRefScope(tmp);
             return tmp;
         }
     }
@@ -92,6 +94,17 @@ DdNode* BddCondManager::NEG(DdNode* lhs) {
 }
 //@}
 
+/*!
+ * Dereference the conditions of a scope. Their nodes are reclaimed by the
+ * next garbage collection unless they are referenced elsewhere.
+ */
+void BddCondManager::releaseScope(DdNodeVector& scope) {
+    assert(refScope != &scope && "releasing the current scope?");
+    for (DdNodeVector::const_iterator it = scope.begin(), eit = scope.end(); it != eit; ++it)
+        Cudd_RecursiveDeref(m_bdd_mgr, *it);
+    scope.clear();
+}
+
 /*!
  * Utilities for dumping conditions. These methods use global functions from CUDD
  * package and they can be removed outside this class scope to be used by others.
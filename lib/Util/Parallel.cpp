@@ -0,0 +1,47 @@
+//===- Parallel.cpp -- Running independent work items on several threads -----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * Parallel.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "Util/Parallel.h"
+#include "Util/PointsTo.h"
+
+static llvm::cl::opt<unsigned> NumOfThreads("svf-threads", llvm::cl::init(0),
+        llvm::cl::desc("Number of threads used by parallel analysis modes (0: one per hardware thread)"));
+
+u32_t SVFUtil::getNumOfThreads() {
+    if (NumOfThreads != 0)
+        return NumOfThreads;
+
+    u32_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads != 0 ? hardwareThreads : 1;
+}
+
+u32_t SVFUtil::getNumOfPtsWorkers() {
+    if (PointsTo::getDefaultType() == PointsTo::HCS)
+        return 1;
+    return getNumOfThreads();
+}
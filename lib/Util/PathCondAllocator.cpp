@@ -47,6 +47,21 @@ BddCondManager* PathCondAllocator::bddCondMgr = NULL;
 static llvm::cl::opt<bool> PrintPathCond("print-pc", llvm::cl::init(false),
                                    llvm::cl::desc("Print out path condition"));
 
+static llvm::cl::opt<unsigned> BddGCInterval("bdd-gc-interval", llvm::cl::init(0),
+                                   llvm::cl::desc("Garbage collect BDDs after every given number of released condition scopes (0: left to CUDD)"));
+
+static llvm::cl::opt<bool> GuardCaching("guard-cache", llvm::cl::init(true),
+                                   llvm::cl::desc("Memoise value-flow guards across slices"));
+
+static llvm::cl::opt<bool> BddReorder("bdd-reorder", llvm::cl::init(false),
+                                   llvm::cl::desc("Reorder BDD variables at each BDD garbage collection"));
+
+static llvm::cl::opt<bool> GuardCacheCheck("guard-cache-check", llvm::cl::init(false),
+                                   llvm::cl::desc("Recompute the memoised value-flow guards on each cache hit and compare"));
+
+static llvm::cl::opt<bool> BddCheckRelease("bdd-check-release", llvm::cl::init(false),
+                                   llvm::cl::desc("Check the BDD reference counts after each release of the conditions of a slice"));
+
 /*!
  * Allocate path condition for each branch
  */
@@ -369,17 +384,84 @@ PathCondAllocator::Condition* PathCondAllocator::getPHIComplementCond(const Basi
     return trueCond();
 }
 
+/*!
+ * Guard computation entry points
+ */
+//@{
+PathCondAllocator::Condition* PathCondAllocator::ComputeIntraVFGGuard(const BasicBlock* srcBB, const BasicBlock* dstBB) {
+    return getGuard(IntraGuard, srcBB, dstBB, NULL);
+}
+PathCondAllocator::Condition* PathCondAllocator::ComputeInterCallVFGGuard(const BasicBlock* srcBB, const BasicBlock* dstBB, const BasicBlock* callBB) {
+    return getGuard(InterCallGuard, srcBB, dstBB, callBB);
+}
+PathCondAllocator::Condition* PathCondAllocator::ComputeInterRetVFGGuard(const BasicBlock* srcBB, const BasicBlock* dstBB, const BasicBlock* retBB) {
+    return getGuard(InterRetGuard, srcBB, dstBB, retBB);
+}
+//@}
+
+/*!
+ * A guard only depends on its basic blocks and on the value evaluated by
+ * branch conditions if its computation starts with no control-flow
+ * conditions, as each value-flow guard of a slice does. Such guards are
+ * memoised, and referenced by the cache so that they outlive the slices
+ * releasing their conditions.
+ */
+PathCondAllocator::Condition* PathCondAllocator::getGuard(GuardKind kind, const BasicBlock* srcBB, const BasicBlock* dstBB, const BasicBlock* callRetBB) {
+    bool cacheable = GuardCaching && bbToCondMap.empty();
+    GuardKey key(kind, srcBB, dstBB, callRetBB, getCurEvalVal());
+    Condition* cached = NULL;
+    if (cacheable) {
+        GuardCache::const_iterator it = guardCache.find(key);
+        if (it != guardCache.end()) {
+            numOfGuardCacheHits++;
+            if (!GuardCacheCheck)
+                return it->second;
+            cached = it->second;
+        }
+        else
+            numOfGuardCacheMisses++;
+    }
+
+    Condition* guard = NULL;
+    switch (kind) {
+    case IntraGuard:
+        guard = computeIntraGuard(srcBB, dstBB);
+        break;
+    case InterCallGuard:
+        guard = computeInterCallGuard(srcBB, dstBB, callRetBB);
+        break;
+    case InterRetGuard:
+        guard = computeInterRetGuard(srcBB, dstBB, callRetBB);
+        break;
+    }
+
+    if (cached) {
+        /// BDDs are canonical, so an equal guard is the same node. Leave no
+        /// control-flow conditions behind, as a plain cache hit does.
+        if (guard != cached)
+            numOfStaleGuards++;
+        clearCFCond();
+        return cached;
+    }
+
+    if (cacheable) {
+        condMgr->retain(guard);
+        guardCache[key] = guard;
+    }
+    return guard;
+}
+
 /*!
  * Compute calling inter-procedural guards between two SVFGNodes (from caller to callee)
  * src --c1--> callBB --true--> funEntryBB --c2--> dst
  * the InterCallVFGGuard is c1 ^ c2
  */
-PathCondAllocator::Condition* PathCondAllocator::ComputeInterCallVFGGuard(const BasicBlock* srcBB, const BasicBlock* dstBB, const BasicBlock* callBB) {
+PathCondAllocator::Condition* PathCondAllocator::computeInterCallGuard(const BasicBlock* srcBB, const BasicBlock* dstBB, const BasicBlock* callBB) {
     const BasicBlock* funEntryBB = &dstBB->getParent()->getEntryBlock();
 
-    Condition* c1 = ComputeIntraVFGGuard(srcBB,callBB);
+    Condition* c1 = computeIntraGuard(srcBB,callBB);
     setCFCond(funEntryBB,condOr(getCFCond(funEntryBB),getCFCond(callBB)));
-    Condition* c2 = ComputeIntraVFGGuard(funEntryBB,dstBB);
+    Condition* c2 = computeIntraGuard(funEntryBB,dstBB);
     return condAnd(c1,c2);
 }
 
@@ -388,19 +470,19 @@ PathCondAllocator::Condition* PathCondAllocator::ComputeInterCallVFGGuard(const
  * src --c1--> funExitBB --true--> retBB --c2--> dst
  * the InterRetVFGGuard is c1 ^ c2
  */
-PathCondAllocator::Condition* PathCondAllocator::ComputeInterRetVFGGuard(const BasicBlock*  srcBB, const BasicBlock*  dstBB, const BasicBlock* retBB) {
+PathCondAllocator::Condition* PathCondAllocator::computeInterRetGuard(const BasicBlock*  srcBB, const BasicBlock*  dstBB, const BasicBlock* retBB) {
     const BasicBlock* funExitBB = getFunExitBB(srcBB->getParent());
 
-    Condition* c1 = ComputeIntraVFGGuard(srcBB,funExitBB);
+    Condition* c1 = computeIntraGuard(srcBB,funExitBB);
     setCFCond(retBB,condOr(getCFCond(retBB),getCFCond(funExitBB)));
-    Condition* c2 = ComputeIntraVFGGuard(retBB,dstBB);
+    Condition* c2 = computeIntraGuard(retBB,dstBB);
     return condAnd(c1,c2);
 }
 
 /*!
  * Compute intra-procedural guards between two SVFGNodes (inside same function)
  */
-PathCondAllocator::Condition* PathCondAllocator::ComputeIntraVFGGuard(const BasicBlock* srcBB, const BasicBlock* dstBB) {
+PathCondAllocator::Condition* PathCondAllocator::computeIntraGuard(const BasicBlock* srcBB, const BasicBlock* dstBB) {
 
     assert(srcBB->getParent() == dstBB->getParent() && "two basic blocks are not in the same function??");
 
@@ -450,12 +532,65 @@ PathCondAllocator::Condition* PathCondAllocator::ComputeIntraVFGGuard(const Basi
 }
 
 
+/*!
+ * Release the conditions of a scope, e.g. of a slice which has been checked.
+ * CUDD reclaims dead nodes by itself when its tables fill up; with
+ * -bdd-gc-interval it is also done periodically, and optionally followed by
+ * variable reordering, between scopes.
+ */
+void PathCondAllocator::releaseConds(CondVector& conds) {
+    condMgr->releaseScope(conds);
+    numOfReleases++;
+    if (BddGCInterval > 0 && numOfReleases % BddGCInterval == 0) {
+        condMgr->collectGarbage();
+        if (BddReorder)
+            condMgr->reorder();
+    }
+
+    /// A condition released once too often (or still in use elsewhere and
+    /// collected) leaves the reference counts inconsistent
+    if (BddCheckRelease && !condMgr->isConsistent())
+        numOfBadReleases++;
+}
+
 /*!
  * Release memory
  */
 void PathCondAllocator::destroy() {
-    delete bddCondMgr;
-    bddCondMgr = NULL;
+    if (condMgr != NULL) {
+        for (GuardCache::const_iterator it = guardCache.begin(), eit = guardCache.end(); it != eit; ++it)
+            condMgr->markForRelease(it->second);
+    }
+    guardCache.clear();
+
+    if (ownsCondMgr) {
+        delete condMgr;
+    }
+    else {
+        delete bddCondMgr;
+        bddCondMgr = NULL;
+    }
+    condMgr = NULL;
+}
+
+/*!
+ * Report the checks done along the analysis, each enabled by its option
+ */
+void PathCondAllocator::validateCondTests() {
+    if (BddCheckRelease) {
+        outs() << "[PathCondAllocator] Checking the BDDs after " << numOfReleases << " releases of slice conditions\n";
+        if (numOfBadReleases == 0)
+            outs() << sucMsg("\t SUCCESS :") << "the reference counts stayed consistent\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << numOfBadReleases << " releases left the reference counts inconsistent\n";
+    }
+    if (GuardCacheCheck) {
+        outs() << "[PathCondAllocator] Checking " << numOfGuardCacheHits << " value-flow guards taken from the cache\n";
+        if (numOfStaleGuards == 0)
+            outs() << sucMsg("\t SUCCESS :") << "the cached guards are the recomputed ones\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << numOfStaleGuards << " cached guards differ from the recomputed ones\n";
+    }
 }
 
 /*!
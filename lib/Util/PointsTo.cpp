@@ -0,0 +1,708 @@
+//===- PointsTo.cpp -- Points-to set with selectable representation ----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * PointsTo.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "Util/PointsTo.h"
+#include <llvm/ADT/Hashing.h>
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+/// Hashes the elements of a NodeBS (for hash-consing).
+struct NodeBSHash {
+    size_t operator()(const NodeBS &nbs) const {
+        size_t h = 0;
+        for (NodeBS::iterator it = nbs.begin(), eit = nbs.end(); it != eit; ++it)
+            h = llvm::hash_combine(h, *it);
+        return h;
+    }
+};
+
+typedef std::unordered_set<NodeBS, NodeBSHash> HashConsedSets;
+typedef DenseMap<std::pair<const NodeBS *, const NodeBS *>, const NodeBS *> HashConsedUnionCache;
+
+/// Canonical sets. Elements of an unordered_set are never moved, so we can
+/// hand out pointers to them. The tables are never destroyed, so that sets
+/// destroyed during static destruction can still release theirs.
+HashConsedSets &getHashConsedSets(void) {
+    static HashConsedSets *hashConsedSets = new HashConsedSets();
+    return *hashConsedSets;
+}
+
+/// Memoised unions of canonical sets.
+HashConsedUnionCache &getHashConsedUnionCache(void) {
+    static HashConsedUnionCache *unionCache = new HashConsedUnionCache();
+    return *unionCache;
+}
+
+u32_t hashConsedUnionHits = 0;
+
+/// Number of live HCS sets.
+u32_t numOfLiveHashConsed = 0;
+
+/// The thread using the tables since they were last freed.
+std::thread::id hashConsingThread;
+
+/// The tables are not synchronised, so they must only be used by one thread.
+inline void assertHashConsingThread(void) {
+#ifndef NDEBUG
+    if (hashConsingThread == std::thread::id())
+        hashConsingThread = std::this_thread::get_id();
+    assert(hashConsingThread == std::this_thread::get_id() && "HCS points-to sets used by several threads");
+#endif
+}
+
+}
+
+PointsTo::Type PointsTo::defaultType = PointsTo::SBV;
+
+PointsTo::PointsTo(void) {
+    initialise(defaultType);
+}
+
+PointsTo::PointsTo(Type type) {
+    initialise(type);
+}
+
+PointsTo::PointsTo(const PointsTo &pt) {
+    copyFrom(pt);
+}
+
+PointsTo::PointsTo(PointsTo &&pt) : type(pt.type) {
+    switch (type) {
+    case SBV: new (&sbv) NodeBS(std::move(pt.sbv)); break;
+    case BV:  new (&bv) DenseBV(std::move(pt.bv)); break;
+    case SV:  new (&sv) SortedVector(std::move(pt.sv)); break;
+    case HCS: hc = pt.hc; pt.hc.pending = NULL; retainHashConsed(); break;
+    }
+}
+
+PointsTo::PointsTo(const NodeBS &nbs) {
+    initialise(defaultType);
+    *this |= nbs;
+}
+
+PointsTo::~PointsTo(void) {
+    destroy();
+}
+
+PointsTo &PointsTo::operator=(const PointsTo &rhs) {
+    if (this == &rhs) return *this;
+
+    if (type == rhs.type) {
+        switch (type) {
+        case SBV: sbv = rhs.sbv; break;
+        case BV:  bv = rhs.bv; break;
+        case SV:  sv = rhs.sv; break;
+        case HCS: {
+            const NodeBS *set = rhs.canonical();
+            delete hc.pending;
+            hc.pending = NULL;
+            hc.set = set;
+            break;
+        }
+        }
+    } else {
+        destroy();
+        copyFrom(rhs);
+    }
+
+    return *this;
+}
+
+PointsTo &PointsTo::operator=(PointsTo &&rhs) {
+    if (this == &rhs) return *this;
+
+    destroy();
+    type = rhs.type;
+    switch (type) {
+    case SBV: new (&sbv) NodeBS(std::move(rhs.sbv)); break;
+    case BV:  new (&bv) DenseBV(std::move(rhs.bv)); break;
+    case SV:  new (&sv) SortedVector(std::move(rhs.sv)); break;
+    case HCS: hc = rhs.hc; rhs.hc.pending = NULL; retainHashConsed(); break;
+    }
+
+    return *this;
+}
+
+bool PointsTo::empty(void) const {
+    switch (type) {
+    case SBV: return sbv.empty();
+    case BV:  return bv.none();
+    case SV:  return sv.empty();
+    case HCS: return hashConsedElems().empty();
+    }
+
+    assert(false && "PointsTo::empty: unknown type");
+    return true;
+}
+
+u32_t PointsTo::count(void) const {
+    switch (type) {
+    case SBV: return sbv.count();
+    case BV:  return bv.count();
+    case SV:  return sv.size();
+    case HCS: return hashConsedElems().count();
+    }
+
+    assert(false && "PointsTo::count: unknown type");
+    return 0;
+}
+
+void PointsTo::clear(void) {
+    switch (type) {
+    case SBV: sbv.clear(); break;
+    case BV:  bv.clear(); break;
+    case SV:  sv.clear(); break;
+    case HCS: {
+        delete hc.pending;
+        hc.pending = NULL;
+        hc.set = emptyHashConsed();
+        break;
+    }
+    }
+}
+
+bool PointsTo::test(NodeID n) const {
+    switch (type) {
+    case SBV: return sbv.test(n);
+    case BV:  return n < bv.size() && bv.test(n);
+    case SV:  return std::binary_search(sv.begin(), sv.end(), n);
+    case HCS: return hashConsedElems().test(n);
+    }
+
+    assert(false && "PointsTo::test: unknown type");
+    return false;
+}
+
+bool PointsTo::test_and_set(NodeID n) {
+    switch (type) {
+    case SBV: return sbv.test_and_set(n);
+    case BV: {
+        if (n >= bv.size()) bv.resize(n + 1);
+        else if (bv.test(n)) return false;
+        bv.set(n);
+        return true;
+    }
+    case SV: {
+        SortedVector::iterator it = std::lower_bound(sv.begin(), sv.end(), n);
+        if (it != sv.end() && *it == n) return false;
+        sv.insert(it, n);
+        return true;
+    }
+    case HCS: {
+        if (hashConsedElems().test(n)) return false;
+        pendingElems().set(n);
+        return true;
+    }
+    }
+
+    assert(false && "PointsTo::test_and_set: unknown type");
+    return false;
+}
+
+void PointsTo::set(NodeID n) {
+    test_and_set(n);
+}
+
+void PointsTo::reset(NodeID n) {
+    switch (type) {
+    case SBV: sbv.reset(n); break;
+    case BV:  if (n < bv.size()) bv.reset(n); break;
+    case SV: {
+        SortedVector::iterator it = std::lower_bound(sv.begin(), sv.end(), n);
+        if (it != sv.end() && *it == n) sv.erase(it);
+        break;
+    }
+    case HCS: {
+        if (!hashConsedElems().test(n)) break;
+        pendingElems().reset(n);
+        break;
+    }
+    }
+}
+
+int PointsTo::find_first(void) const {
+    switch (type) {
+    case SBV: return sbv.find_first();
+    case BV:  return bv.find_first();
+    case SV:  return sv.empty() ? -1 : (int)sv.front();
+    case HCS: return hashConsedElems().find_first();
+    }
+
+    assert(false && "PointsTo::find_first: unknown type");
+    return -1;
+}
+
+bool PointsTo::contains(const PointsTo &rhs) const {
+    if (type != rhs.type) {
+        PointsTo crhs(rhs);
+        crhs.convert(type);
+        return contains(crhs);
+    }
+
+    switch (type) {
+    case SBV: return sbv.contains(rhs.sbv);
+    case BV:  return !rhs.bv.test(bv);
+    case SV:  return std::includes(sv.begin(), sv.end(), rhs.sv.begin(), rhs.sv.end());
+    case HCS: {
+        const NodeBS *lhsSet = canonical(), *rhsSet = rhs.canonical();
+        return lhsSet == rhsSet || lhsSet->contains(*rhsSet);
+    }
+    }
+
+    assert(false && "PointsTo::contains: unknown type");
+    return false;
+}
+
+bool PointsTo::intersects(const PointsTo &rhs) const {
+    if (type != rhs.type) {
+        PointsTo crhs(rhs);
+        crhs.convert(type);
+        return intersects(crhs);
+    }
+
+    switch (type) {
+    case SBV: return sbv.intersects(rhs.sbv);
+    case BV:  return bv.anyCommon(rhs.bv);
+    case SV: {
+        SortedVector::const_iterator lit = sv.begin(), rit = rhs.sv.begin();
+        while (lit != sv.end() && rit != rhs.sv.end()) {
+            if (*lit < *rit) ++lit;
+            else if (*rit < *lit) ++rit;
+            else return true;
+        }
+        return false;
+    }
+    case HCS: {
+        const NodeBS *lhsSet = canonical(), *rhsSet = rhs.canonical();
+        return !lhsSet->empty() && (lhsSet == rhsSet || lhsSet->intersects(*rhsSet));
+    }
+    }
+
+    assert(false && "PointsTo::intersects: unknown type");
+    return false;
+}
+
+bool PointsTo::operator==(const PointsTo &rhs) const {
+    if (type != rhs.type) {
+        PointsTo crhs(rhs);
+        crhs.convert(type);
+        return *this == crhs;
+    }
+
+    switch (type) {
+    case SBV: return sbv == rhs.sbv;
+    // BitVector equality also compares sizes, which we don't care about.
+    case BV:  return !bv.test(rhs.bv) && !rhs.bv.test(bv);
+    case SV:  return sv == rhs.sv;
+    // Canonical sets are equal iff they are the same set.
+    case HCS: return canonical() == rhs.canonical();
+    }
+
+    assert(false && "PointsTo::==: unknown type");
+    return false;
+}
+
+bool PointsTo::operator|=(const PointsTo &rhs) {
+    if (type != rhs.type) {
+        PointsTo crhs(rhs);
+        crhs.convert(type);
+        return *this |= crhs;
+    }
+
+    switch (type) {
+    case SBV: return sbv |= rhs.sbv;
+    case BV: {
+        // Does rhs have anything we don't?
+        if (!rhs.bv.test(bv)) return false;
+        bv |= rhs.bv;
+        return true;
+    }
+    case SV: {
+        if (rhs.sv.empty()) return false;
+        SortedVector result;
+        std::set_union(sv.begin(), sv.end(), rhs.sv.begin(), rhs.sv.end(),
+                       std::back_inserter(result));
+        if (result.size() == sv.size()) return false;
+        sv = std::move(result);
+        return true;
+    }
+    case HCS: {
+        const NodeBS *lhsSet = canonical();
+        const NodeBS *result = hashConsedUnion(lhsSet, rhs.canonical());
+        if (result == lhsSet) return false;
+        hc.set = result;
+        return true;
+    }
+    }
+
+    assert(false && "PointsTo::|=: unknown type");
+    return false;
+}
+
+bool PointsTo::operator|=(const NodeBS &rhs) {
+    switch (type) {
+    case SBV: return sbv |= rhs;
+    case HCS: {
+        if (hashConsedElems().contains(rhs)) return false;
+        pendingElems() |= rhs;
+        return true;
+    }
+    default: {
+        bool changed = false;
+        for (NodeBS::iterator it = rhs.begin(), eit = rhs.end(); it != eit; ++it)
+            changed = test_and_set(*it) || changed;
+        return changed;
+    }
+    }
+}
+
+bool PointsTo::operator&=(const PointsTo &rhs) {
+    if (type != rhs.type) {
+        PointsTo crhs(rhs);
+        crhs.convert(type);
+        return *this &= crhs;
+    }
+
+    switch (type) {
+    case SBV: return sbv &= rhs.sbv;
+    case BV: {
+        // Do we have anything rhs doesn't?
+        if (!bv.test(rhs.bv)) return false;
+        bv &= rhs.bv;
+        return true;
+    }
+    case SV: {
+        SortedVector result;
+        std::set_intersection(sv.begin(), sv.end(), rhs.sv.begin(), rhs.sv.end(),
+                              std::back_inserter(result));
+        if (result.size() == sv.size()) return false;
+        sv = std::move(result);
+        return true;
+    }
+    case HCS: {
+        const NodeBS &rhsElems = rhs.hashConsedElems();
+        if (rhsElems.contains(hashConsedElems())) return false;
+        pendingElems() &= rhsElems;
+        return true;
+    }
+    }
+
+    assert(false && "PointsTo::&=: unknown type");
+    return false;
+}
+
+bool PointsTo::intersectWithComplement(const PointsTo &rhs) {
+    if (type != rhs.type) {
+        PointsTo crhs(rhs);
+        crhs.convert(type);
+        return intersectWithComplement(crhs);
+    }
+
+    switch (type) {
+    case SBV: return sbv.intersectWithComplement(rhs.sbv);
+    case BV: {
+        if (!bv.anyCommon(rhs.bv)) return false;
+        bv.reset(rhs.bv);
+        return true;
+    }
+    case SV: {
+        SortedVector result;
+        std::set_difference(sv.begin(), sv.end(), rhs.sv.begin(), rhs.sv.end(),
+                            std::back_inserter(result));
+        if (result.size() == sv.size()) return false;
+        sv = std::move(result);
+        return true;
+    }
+    case HCS: {
+        const NodeBS &rhsElems = rhs.hashConsedElems();
+        if (!hashConsedElems().intersects(rhsElems)) return false;
+        pendingElems().intersectWithComplement(rhsElems);
+        return true;
+    }
+    }
+
+    assert(false && "PointsTo::intersectWithComplement: unknown type");
+    return false;
+}
+
+void PointsTo::intersectWithComplement(const PointsTo &lhs, const PointsTo &rhs) {
+    if (type == SBV && lhs.type == SBV && rhs.type == SBV) {
+        sbv.intersectWithComplement(lhs.sbv, rhs.sbv);
+        return;
+    }
+
+    // Keep our type regardless of lhs's.
+    PointsTo result(lhs);
+    result.convert(type);
+    result.intersectWithComplement(rhs);
+    *this = std::move(result);
+}
+
+PointsTo PointsTo::operator-(const PointsTo &rhs) const {
+    PointsTo result(*this);
+    result.intersectWithComplement(rhs);
+    return result;
+}
+
+NodeBS PointsTo::toNodeBS(void) const {
+    switch (type) {
+    case SBV: return sbv;
+    case HCS: return hashConsedElems();
+    default: {
+        NodeBS nbs;
+        for (iterator it = begin(), eit = end(); it != eit; ++it)
+            nbs.set(*it);
+        return nbs;
+    }
+    }
+}
+
+PointsTo::iterator PointsTo::begin(void) const {
+    return iterator(this);
+}
+
+PointsTo::iterator PointsTo::end(void) const {
+    return iterator(this, true);
+}
+
+u32_t PointsTo::numHashConsedSets(void) {
+    return getHashConsedSets().size();
+}
+
+u32_t PointsTo::numHashConsedUnionHits(void) {
+    return hashConsedUnionHits;
+}
+
+void PointsTo::initialise(Type t) {
+    type = t;
+    switch (type) {
+    case SBV: new (&sbv) NodeBS(); break;
+    case BV:  new (&bv) DenseBV(); break;
+    case SV:  new (&sv) SortedVector(); break;
+    case HCS: {
+        hc.set = emptyHashConsed();
+        hc.pending = NULL;
+        retainHashConsed();
+        break;
+    }
+    }
+}
+
+void PointsTo::destroy(void) {
+    switch (type) {
+    case SBV: sbv.~NodeBS(); break;
+    case BV:  bv.~DenseBV(); break;
+    case SV:  sv.~SortedVector(); break;
+    case HCS: delete hc.pending; releaseHashConsed(); break;
+    }
+}
+
+void PointsTo::copyFrom(const PointsTo &rhs) {
+    type = rhs.type;
+    switch (type) {
+    case SBV: new (&sbv) NodeBS(rhs.sbv); break;
+    case BV:  new (&bv) DenseBV(rhs.bv); break;
+    case SV:  new (&sv) SortedVector(rhs.sv); break;
+    case HCS: {
+        hc.set = rhs.canonical();
+        hc.pending = NULL;
+        retainHashConsed();
+        break;
+    }
+    }
+}
+
+void PointsTo::convert(Type t) {
+    if (t == type) return;
+
+    NodeBS nbs = toNodeBS();
+    destroy();
+    initialise(t);
+
+    switch (type) {
+    case SBV: sbv = nbs; break;
+    case HCS: hc.set = hashCons(nbs); break;
+    default: *this |= nbs; break;
+    }
+}
+
+const NodeBS *PointsTo::canonical(void) const {
+    if (hc.pending != NULL) {
+        hc.set = hashCons(*hc.pending);
+        delete hc.pending;
+        hc.pending = NULL;
+    }
+    return hc.set;
+}
+
+NodeBS &PointsTo::pendingElems(void) {
+    if (hc.pending == NULL)
+        hc.pending = new NodeBS(*hc.set);
+    return *hc.pending;
+}
+
+const NodeBS *PointsTo::hashCons(const NodeBS &nbs) {
+    if (nbs.empty()) return emptyHashConsed();
+    assertHashConsingThread();
+    return &*getHashConsedSets().insert(nbs).first;
+}
+
+/// The empty set is kept out of the table, so that it survives its release.
+const NodeBS *PointsTo::emptyHashConsed(void) {
+    static const NodeBS *emptySet = new NodeBS();
+    return emptySet;
+}
+
+const NodeBS *PointsTo::hashConsedUnion(const NodeBS *lhs, const NodeBS *rhs) {
+    assertHashConsingThread();
+    if (lhs == rhs || rhs->empty()) return lhs;
+    if (lhs->empty()) return rhs;
+
+    // Union is commutative; order the key so both orders share an entry.
+    std::pair<const NodeBS *, const NodeBS *> key = lhs < rhs ? std::make_pair(lhs, rhs)
+                                                              : std::make_pair(rhs, lhs);
+    HashConsedUnionCache &unionCache = getHashConsedUnionCache();
+    HashConsedUnionCache::const_iterator it = unionCache.find(key);
+    if (it != unionCache.end()) {
+        ++hashConsedUnionHits;
+        return it->second;
+    }
+
+    NodeBS nbs = *lhs;
+    const NodeBS *result = (nbs |= *rhs) ? hashCons(nbs) : lhs;
+    unionCache[key] = result;
+    return result;
+}
+
+void PointsTo::retainHashConsed(void) {
+    assertHashConsingThread();
+    ++numOfLiveHashConsed;
+}
+
+void PointsTo::releaseHashConsed(void) {
+    assertHashConsingThread();
+    assert(numOfLiveHashConsed > 0 && "releasing more HCS sets than created?");
+    if (--numOfLiveHashConsed == 0) {
+        getHashConsedSets().clear();
+        getHashConsedUnionCache().clear();
+        hashConsingThread = std::thread::id();
+    }
+}
+
+PointsTo::PointsToIterator::PointsToIterator(const PointsTo *pt, bool end) : type(pt->type) {
+    switch (type) {
+    case SBV:
+        new (&sbvIt) NodeBS::iterator(end ? pt->sbv.end() : pt->sbv.begin());
+        break;
+    case HCS:
+        new (&sbvIt) NodeBS::iterator(end ? pt->canonical()->end() : pt->canonical()->begin());
+        break;
+    case BV:
+        bvIt.bv = &pt->bv;
+        bvIt.idx = end ? -1 : pt->bv.find_first();
+        break;
+    case SV:
+        svIt = end ? pt->sv.end() : pt->sv.begin();
+        break;
+    }
+}
+
+PointsTo::PointsToIterator::PointsToIterator(const PointsToIterator &pt) {
+    copyFrom(pt);
+}
+
+PointsTo::PointsToIterator::~PointsToIterator(void) {
+    destroy();
+}
+
+PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator=(const PointsToIterator &rhs) {
+    if (this == &rhs) return *this;
+    destroy();
+    copyFrom(rhs);
+    return *this;
+}
+
+PointsTo::PointsToIterator &PointsTo::PointsToIterator::operator++(void) {
+    switch (type) {
+    case SBV:
+    case HCS: ++sbvIt; break;
+    case BV:  bvIt.idx = bvIt.bv->find_next(bvIt.idx); break;
+    case SV:  ++svIt; break;
+    }
+
+    return *this;
+}
+
+PointsTo::PointsToIterator PointsTo::PointsToIterator::operator++(int) {
+    PointsToIterator old(*this);
+    ++*this;
+    return old;
+}
+
+NodeID PointsTo::PointsToIterator::operator*(void) const {
+    switch (type) {
+    case SBV:
+    case HCS: return *sbvIt;
+    case BV:  return bvIt.idx;
+    case SV:  return *svIt;
+    }
+
+    assert(false && "PointsToIterator::*: unknown type");
+    return 0;
+}
+
+bool PointsTo::PointsToIterator::operator==(const PointsToIterator &rhs) const {
+    assert(type == rhs.type && "PointsToIterator::==: comparing iterators of different types");
+    switch (type) {
+    case SBV:
+    case HCS: return sbvIt == rhs.sbvIt;
+    case BV:  return bvIt.bv == rhs.bvIt.bv && bvIt.idx == rhs.bvIt.idx;
+    case SV:  return svIt == rhs.svIt;
+    }
+
+    assert(false && "PointsToIterator::==: unknown type");
+    return false;
+}
+
+void PointsTo::PointsToIterator::destroy(void) {
+    typedef NodeBS::iterator NodeBSIterator;
+    if (type == SBV || type == HCS) sbvIt.~NodeBSIterator();
+}
+
+void PointsTo::PointsToIterator::copyFrom(const PointsToIterator &rhs) {
+    type = rhs.type;
+    switch (type) {
+    case SBV:
+    case HCS: new (&sbvIt) NodeBS::iterator(rhs.sbvIt); break;
+    case BV:  bvIt = rhs.bvIt; break;
+    case SV:  svIt = rhs.svIt; break;
+    }
+}
@@ -102,7 +102,7 @@ void SVFUtil::getFunReachableBBs (const Function * fun, DominatorTree* dt, std::
 /*!
  * Return true if the function has a return instruction reachable from function entry
  */
-bool SVFUtil::functionDoesNotRet (const Function * fun) {
+bool SVFUtil::functionDoesNotRet (const Function * fun, bool warn) {
 
     std::vector<const BasicBlock*> bbVec;
     std::set<const BasicBlock*> visited;
@@ -126,7 +126,7 @@ bool SVFUtil::functionDoesNotRet (const Function * fun) {
             bbVec.push_back(succbb);
         }
     }
-    if(isProgEntryFunction(fun)==false) {
+    if(warn && isProgEntryFunction(fun)==false) {
         writeWrnMsg(fun->getName().str() + " does not have return");
     }
     return true;
@@ -477,6 +477,16 @@ void SVFUtil::dumpSet(NodeBS bs, raw_ostream & O) {
     }
 }
 
+/*!
+ * Dump points-to set
+ */
+void SVFUtil::dumpSet(const PointsTo& pts, raw_ostream & O) {
+    for (PointsTo::iterator ii = pts.begin(), ie = pts.end();
+            ii != ie; ++ii) {
+        O << " " << *ii << " ";
+    }
+}
+
 /*!
  * Print memory usage
  */
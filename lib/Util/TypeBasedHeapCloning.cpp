@@ -105,6 +105,11 @@ void TypeBasedHeapCloning::addGepToObj(NodeID gep, NodeID base, unsigned offset)
 
     objToGeps[base].set(gep);
     memObjToGeps[baseMemObj][offset].set(gep);
+
+    // Index by the gep's own offset; that is what getGepObjClones matches on.
+    if (const GepObjPN *gepNode = SVFUtil::dyn_cast<GepObjPN>(ppag->getPAGNode(gep))) {
+        objToGepsAtOffset[base][gepNode->getLocationSet().getOffset()].set(gep);
+    }
 }
 
 const NodeBS &TypeBasedHeapCloning::getGepObjsFromMemObj(const MemObj *memObj, unsigned offset) {
@@ -150,27 +155,9 @@ const NodeBS TypeBasedHeapCloning::getGepObjClones(NodeID base, unsigned offset)
         return geps;
     }
 
-    // Caching on offset would improve performance but it seems minimal.
-    const NodeBS &gepObjs = getGepObjs(base);
-    for (NodeID gep : gepObjs) {
-        PAGNode *node = ppag->getPAGNode(gep);
-        assert(node && "TBHC: expected gep node doesn't exist.");
-        assert((SVFUtil::isa<GepObjPN>(node) || SVFUtil::isa<FIObjPN>(node))
-               && "TBHC: expected a GEP or FI object.");
-
-        if (GepObjPN *gepNode = SVFUtil::dyn_cast<GepObjPN>(node)) {
-            if (gepNode->getLocationSet().getOffset() == totalOffset) {
-                geps.set(gep);
-            }
-        } else {
-            // Definitely a FIObj (asserted), but we don't want to add it if
-            // the object is field-sensitive because in that case it actually
-            // represents the 0th field, not the whole object.
-            if (baseNode->getMemObj()->isFieldInsensitive()) {
-                geps.set(gep);
-            }
-        }
-    }
+    // Only GEP objects can match: a FIObj represents the whole object (handled above)
+    // when the object is field-insensitive, and the 0th field otherwise.
+    geps |= objToGepsAtOffset[base][totalOffset];
 
     if (geps.empty()) {
         // No gep node has even be created, so create one.
@@ -230,9 +217,19 @@ bool TypeBasedHeapCloning::init(NodeID loc, NodeID p, const DIType *tildet, bool
     PointsTo pNewPt;
 
     PointsTo &filterSet = getFilterSet(loc);
+    PointsTo &keptSet = locToKeptSet[loc];
     for (NodeID o : pPt) {
         // If it's been filtered before, it'll be filtered again.
         if (filterSet.test(o)) continue;
+        // Likewise if it has been kept before. Types and the DCHG do not change,
+        // and becoming field-insensitive only leads to keeping it again.
+        if (keptSet.test(o)) {
+            pNewPt.set(o);
+            ++numFilterCacheHits;
+            continue;
+        }
+
+        ++numFilterCacheMisses;
 
         PAGNode *obj = ppag->getPAGNode(o);
         assert(obj && "TBHC: pointee object does not exist in PAG?");
@@ -327,6 +324,8 @@ bool TypeBasedHeapCloning::init(NodeID loc, NodeID p, const DIType *tildet, bool
 
         if (filter) {
             filterSet.set(o);
+        } else if (prop == o) {
+            keptSet.set(o);
         }
     }
 
@@ -344,15 +343,28 @@ NodeID TypeBasedHeapCloning::cloneObject(NodeID o, const DIType *type, bool reus
     NodeID clone;
     const PAGNode *obj = ppag->getPAGNode(o);
     if (const GepObjPN *gepObj = SVFUtil::dyn_cast<GepObjPN>(obj)) {
-        const NodeBS &clones = getGepObjClones(gepObj->getBaseNode(), gepObj->getLocationSet().getOffset());
-        // TODO: a bit of repetition.
+        NodeID base = gepObj->getBaseNode();
+        unsigned offset = gepObj->getLocationSet().getOffset();
+        DenseMap<const DIType *, NodeID> &typedClones = gepToTypedClone[std::make_pair(base, offset)];
+        DenseMap<const DIType *, NodeID>::const_iterator cloneIt = typedClones.find(type);
+        if (cloneIt != typedClones.end()) {
+            ++numGepCacheHits;
+            return cloneIt->second;
+        }
+
+        ++numGepCacheMisses;
+
+        // First lookup of this type: a GEP object of it may already exist.
+        const NodeBS &clones = getGepObjClones(base, offset);
         for (NodeID clone : clones) {
             if (getType(clone) == type) {
+                typedClones[type] = clone;
                 return clone;
             }
         }
 
         clone = ppag->addCloneGepObjNode(gepObj->getMemObj(), gepObj->getLocationSet());
+        typedClones[type] = clone;
 
         // The base needs to know about the new clone.
         addGepToObj(clone, gepObj->getBaseNode(), gepObj->getLocationSet().getOffset());
@@ -368,13 +380,15 @@ NodeID TypeBasedHeapCloning::cloneObject(NodeID o, const DIType *type, bool reus
     } else if (SVFUtil::isa<FIObjPN>(obj) || SVFUtil::isa<DummyObjPN>(obj)) {
         o = getOriginalObj(o);
         // Check there isn't an appropriate clone already.
-        const NodeBS &clones = getClones(o);
-        for (NodeID clone : clones) {
-            if (getType(clone) == type) {
-                return clone;
-            }
+        DenseMap<const DIType *, NodeID> &typedClones = objToTypedClone[o];
+        DenseMap<const DIType *, NodeID>::const_iterator cloneIt = typedClones.find(type);
+        if (cloneIt != typedClones.end()) {
+            ++numCloneCacheHits;
+            return cloneIt->second;
         }
 
+        ++numCloneCacheMisses;
+
         if (const FIObjPN *fiObj = SVFUtil::dyn_cast<FIObjPN>(obj)) {
             clone = ppag->addCloneFIObjNode(fiObj->getMemObj());
         } else if (const DummyObjPN *dummyObj = SVFUtil::dyn_cast<DummyObjPN>(obj)) {
@@ -385,6 +399,9 @@ NodeID TypeBasedHeapCloning::cloneObject(NodeID o, const DIType *type, bool reus
         // Tracking object<->clone mappings.
         addClone(o, clone);
         setOriginalObj(clone, o);
+        // Only reached for the first clone of a type, which is the one with
+        // the smallest ID as clones are numbered in creation order.
+        typedClones.insert({type, clone});
     } else {
         assert(false && "FSTBHC: trying to clone unhandled object");
     }
@@ -415,18 +432,23 @@ const MDNode *TypeBasedHeapCloning::getRawCTirMetadata(const Value *v) {
 const DIType *TypeBasedHeapCloning::getTypeFromCTirMetadata(const Value *v) {
     assert(v != nullptr && "TBHC: trying to get type from nullptr!");
 
-    const MDNode *mdNode = getRawCTirMetadata(v);
-    if (mdNode == nullptr) {
-        return nullptr;
+    DenseMap<const Value *, const DIType *>::const_iterator typeIt = valueToCTirType.find(v);
+    if (typeIt != valueToCTirType.end()) {
+        return typeIt->second;
     }
 
-    const DIType *type = SVFUtil::dyn_cast<DIType>(mdNode);
-    if (type == nullptr) {
-        SVFUtil::errs() << "TBHC: bad ctir metadata type\n";
-        return nullptr;
+    const DIType *type = nullptr;
+    if (const MDNode *mdNode = getRawCTirMetadata(v)) {
+        type = SVFUtil::dyn_cast<DIType>(mdNode);
+        if (type == nullptr) {
+            SVFUtil::errs() << "TBHC: bad ctir metadata type\n";
+        } else {
+            type = dchg->getCanonicalType(type);
+        }
     }
 
-    return dchg->getCanonicalType(type);
+    valueToCTirType[v] = type;
+    return type;
 }
 
 bool TypeBasedHeapCloning::isGep(const PAGNode *n) const {
@@ -587,6 +609,71 @@ void TypeBasedHeapCloning::validateTBHCTests(SVFModule &svfMod) {
     }
 }
 
+void TypeBasedHeapCloning::validateLookupCacheTests(void) {
+    SVFUtil::outs() << "[" << pta->PTAName() << "] Checking the TBHC lookup caches\n";
+
+    unsigned numFailures = 0;
+    auto check = [&](bool ok, const char *cache, NodeID id) {
+        if (!ok && numFailures++ < 10) {
+            SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << cache << " is wrong for object " << id << "\n";
+        }
+    };
+
+    // GEP objects by offset: what scanning the GEP objects of the base finds.
+    for (const std::pair<NodeID, NodeBS> &baseGeps : objToGeps) {
+        NodeID base = baseGeps.first;
+        DenseMap<unsigned, NodeBS> scanned;
+        for (NodeID gep : baseGeps.second) {
+            if (const GepObjPN *gepNode = SVFUtil::dyn_cast<GepObjPN>(ppag->getPAGNode(gep))) {
+                scanned[gepNode->getLocationSet().getOffset()].set(gep);
+            }
+        }
+
+        DenseMap<unsigned, NodeBS> &indexed = objToGepsAtOffset[base];
+        for (const std::pair<unsigned, NodeBS> &offsetGeps : indexed) {
+            // getGepObjClones leaves empty entries behind.
+            check(offsetGeps.second.empty() || scanned[offsetGeps.first] == offsetGeps.second, "objToGepsAtOffset", base);
+        }
+        for (const std::pair<unsigned, NodeBS> &offsetGeps : scanned) {
+            check(indexed[offsetGeps.first] == offsetGeps.second, "objToGepsAtOffset", base);
+        }
+    }
+
+    // Clones of FI/dummy objects by type: the first clone of the type.
+    for (const std::pair<NodeID, DenseMap<const DIType *, NodeID>> &typedClones : objToTypedClone) {
+        NodeID o = typedClones.first;
+        DenseMap<const DIType *, NodeID> firstClones;
+        for (NodeID clone : getClones(o)) {
+            firstClones.insert({objToType.lookup(clone), clone});
+        }
+        check(firstClones.size() == typedClones.second.size(), "objToTypedClone", o);
+        for (const std::pair<const DIType *, NodeID> &typedClone : typedClones.second) {
+            check(firstClones.lookup(typedClone.first) == typedClone.second, "objToTypedClone", o);
+        }
+    }
+
+    // Clones of GEP objects by type: a GEP object of the base of that type.
+    for (const std::pair<std::pair<NodeID, unsigned>, DenseMap<const DIType *, NodeID>> &typedClones : gepToTypedClone) {
+        NodeID base = typedClones.first.first;
+        for (const std::pair<const DIType *, NodeID> &typedClone : typedClones.second) {
+            NodeID clone = typedClone.second;
+            check(objToType.lookup(clone) == typedClone.first && (clone == base || getGepObjs(base).test(clone)),
+                  "gepToTypedClone", clone);
+        }
+    }
+
+    // Objects kept at a location are never filtered there.
+    for (const std::pair<NodeID, PointsTo> &locKept : locToKeptSet) {
+        check(!getFilterSet(locKept.first).intersects(locKept.second), "locToKeptSet", locKept.first);
+    }
+
+    if (numFailures == 0) {
+        SVFUtil::outs() << SVFUtil::sucMsg("\t SUCCESS :") << "the lookup caches agree with the scans they replace\n";
+    } else {
+        SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << numFailures << " lookup cache entries are wrong\n";
+    }
+}
+
 void TypeBasedHeapCloning::dumpStats(void) {
     std::string indent = "";
     SVFUtil::outs() << "@@@@@@@@@ TBHC STATISTICS @@@@@@@@@\n";
@@ -645,5 +732,13 @@ void TypeBasedHeapCloning::dumpStats(void) {
     SVFUtil::outs() << indent << "REUSE      : " << numSGReuse << "\n";
     SVFUtil::outs() << indent << "AGG CASE   : " << numSGAgg   << "\n";
 
+    SVFUtil::outs() << "\n";
+    indent = "  ";
+    SVFUtil::outs() << indent << "LOOKUP CACHES (HITS/MISSES)\n";
+    indent = "    ";
+    SVFUtil::outs() << indent << "GEP CLONES : " << numGepCacheHits    << "/" << numGepCacheMisses    << "\n";
+    SVFUtil::outs() << indent << "CLONES     : " << numCloneCacheHits  << "/" << numCloneCacheMisses  << "\n";
+    SVFUtil::outs() << indent << "FILTER     : " << numFilterCacheHits << "/" << numFilterCacheMisses << "\n";
+
     SVFUtil::outs() << "@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@\n";
 }
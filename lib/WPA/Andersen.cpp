@@ -29,6 +29,12 @@
 
 #include "WPA/Andersen.h"
 #include "Util/SVFUtil.h"
+#include "Util/SVFModule.h"
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
 
 using namespace SVFUtil;
 
@@ -57,10 +63,29 @@ static llvm::cl::opt<string> WriteAnder("write-ander",  llvm::cl::init(""),
                                   llvm::cl::desc("Write Andersen's analysis results to a file"));
 static llvm::cl::opt<string> ReadAnder("read-ander",  llvm::cl::init(""),
                                  llvm::cl::desc("Read Andersen's analysis results from a file"));
+static llvm::cl::list<string> AnderChangedFuns("ander-changed-funs", llvm::cl::CommaSeparated,
+                                 llvm::cl::desc("Functions edited since -read-ander's results were written; the results not depending on them seed the solver"));
+static llvm::cl::opt<string> AnderCacheDir("ander-cache-dir",  llvm::cl::init(""),
+                                 llvm::cl::desc("Directory caching Andersen's analysis results across runs on the same module (computing the cache key writes the module's bitcode to memory once)"));
+static llvm::cl::opt<bool> CheckIncremental("ander-check-incremental",  llvm::cl::init(false),
+                                 llvm::cl::desc("After seeding with -ander-changed-funs, solve again from scratch and check the results are the same"));
+static llvm::cl::opt<bool> CheckCache("ander-check-cache",  llvm::cl::init(false),
+                                 llvm::cl::desc("On a hit in -ander-cache-dir, solve anyway and check the cached results are the solved ones"));
 static llvm::cl::opt<bool> PtsDiff("diff",  llvm::cl::init(true),
                                     llvm::cl::desc("Disable diff pts propagation"));
 static llvm::cl::opt<bool> MergePWC("merge-pwc",  llvm::cl::init(true),
                                         llvm::cl::desc("Enable PWC in graph solving"));
+static llvm::cl::opt<bool> CheckFixpoint("ander-check-fixpoint",  llvm::cl::init(false),
+                                        llvm::cl::desc("Check that the solved points-to sets of Andersen's analyses are a fixpoint of the constraint graph, and that topo worklists were prioritised topologically"));
+static llvm::cl::opt<WPAConstraintSolver::WorkList::Strategy> AnderWorkList("ander-worklist",
+        llvm::cl::init(WPAConstraintSolver::WorkList::FIFO),
+        llvm::cl::desc("Worklist order of Andersen's analyses"),
+        llvm::cl::values(
+            clEnumValN(WPAConstraintSolver::WorkList::FIFO, "fifo", "First in first out"),
+            clEnumValN(WPAConstraintSolver::WorkList::LRF, "lrf", "Least recently fired first"),
+            clEnumValN(WPAConstraintSolver::WorkList::TOPO, "topo", "Topological order first"),
+            clEnumValN(WPAConstraintSolver::WorkList::TWOPHASE, "2phase", "Two phases, each in topological order")
+        ));
 
 
 /*!
@@ -71,8 +96,24 @@ void Andersen::analyze(SVFModule svfModule) {
     initialize(svfModule);
     
     bool readResultsFromFile = false;
-    if(!ReadAnder.empty())
-        readResultsFromFile = this->readFromFile(ReadAnder);
+    bool checkCacheHit = false;
+    bool seededResults = false;
+    std::string cacheFile = getResultsCacheFile(svfModule);
+    if(!ReadAnder.empty()) {
+        if (AnderChangedFuns.empty())
+            readResultsFromFile = this->readFromFile(ReadAnder);
+        else if (readUnaffectedResults(ReadAnder, std::set<std::string>(AnderChangedFuns.begin(), AnderChangedFuns.end())))
+            seededResults = true;
+        else
+            outs() << "Solving from scratch: results of '" << ReadAnder << "' could not be reused\n";
+    }
+    else if (!cacheFile.empty() && llvm::sys::fs::exists(cacheFile)) {
+        // Solve anyway to compare the cached results with the solved ones.
+        if (CheckCache)
+            checkCacheHit = true;
+        else
+            readResultsFromFile = this->readFromFile(cacheFile);
+    }
 
 	if(!readResultsFromFile) {
 		// Start solving constraints
@@ -82,10 +123,105 @@ void Andersen::analyze(SVFModule svfModule) {
 
 		// Finalize the analysis
 		finalize();
+
+		if (seededResults && CheckIncremental)
+			validateIncrementalTests(svfModule);
 	}
 
-	if (!WriteAnder.empty())
+	if (!WriteAnder.empty()) {
 		this->writeToFile(WriteAnder);
+		// The dependences are only known after solving.
+		if (!readResultsFromFile)
+			this->writeDependencesToFile(WriteAnder + ".deps");
+	}
+
+	if (checkCacheHit)
+		validateCacheTests(cacheFile);
+	else if (!readResultsFromFile && !cacheFile.empty()) {
+		// Write to a unique file first so that concurrent runs never read a partial one.
+		llvm::SmallString<128> tmpFile;
+		int fd;
+		if (!llvm::sys::fs::create_directories(AnderCacheDir)
+				&& !llvm::sys::fs::createUniqueFile(cacheFile + "-%%%%%%.tmp", fd, tmpFile)) {
+			llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+			this->writeToFile(tmpFile.str().str());
+			if (llvm::sys::fs::rename(tmpFile, cacheFile))
+				llvm::sys::fs::remove(tmpFile);
+		}
+	}
+}
+
+/*!
+ * The cache key is a hash of the module's bitcode, of the PAG built from it
+ * (which reflects the options used to build it), and of the options of the
+ * solver. Serialising the bitcode costs about as much as writing the module
+ * to disk, which is small next to solving but is paid on every run with
+ * -ander-cache-dir, hits included. The PAG alone is not a safe key: it does
+ * not capture everything the call graph and external calls depend on.
+ */
+std::string Andersen::getResultsCacheFile(SVFModule svfModule) {
+    if (AnderCacheDir.empty())
+        return "";
+
+    llvm::MD5 hash;
+    auto hashValue = [&hash](u64_t value) {
+        hash.update(llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&value), sizeof(value)));
+    };
+
+    for (u32_t i = 0; i < svfModule.getModuleNum(); ++i) {
+        llvm::SmallVector<char, 0> bitcode;
+        llvm::raw_svector_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(*svfModule.getModule(i), os);
+        hash.update(llvm::StringRef(bitcode.data(), bitcode.size()));
+    }
+
+    for (u32_t kind = PAGEdge::Addr; kind <= PAGEdge::BinaryOp; ++kind) {
+        const PAGEdge::PAGEdgeSetTy& edges = pag->getEdgeSet(static_cast<PAGEdge::PEDGEK>(kind));
+        hashValue(edges.size());
+        for (const PAGEdge* edge : edges) {
+            hashValue(edge->getSrcID());
+            hashValue(edge->getDstID());
+            if (const NormalGepPE* gep = SVFUtil::dyn_cast<NormalGepPE>(edge))
+                hashValue(gep->getOffset());
+        }
+    }
+    for (PAG::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        const ObjPN* obj = SVFUtil::dyn_cast<ObjPN>(it->second);
+        if (obj && obj->getMemObj())
+            hashValue(obj->getMemObj()->getMaxFieldOffsetLimit());
+    }
+
+    hashValue(getAnalysisTy());
+    hashValue(PtsDiff);
+    hashValue(MergePWC);
+
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+
+    llvm::SmallString<128> path(AnderCacheDir);
+    llvm::sys::path::append(path, PTAName() + "-" + result.digest().str().str() + ".ander");
+    return path.str().str();
+}
+
+/*!
+ * The cached results of a hit must be the ones of solving: a difference
+ * means the cache key misses something the results depend on.
+ */
+void Andersen::validateCacheTests(const std::string& cacheFile) {
+    outs() << "[" << PTAName() << "] Checking the cached results are the solved ones\n";
+
+    PTDataTy cachedPtD;
+    StoredGepObjs gepObjs;
+    if (!parseResultsFile(cacheFile, &cachedPtD, gepObjs)) {
+        SVFUtil::errs() << errMsg("\t FAIL :") << "'" << cacheFile << "' cannot be parsed\n";
+        return;
+    }
+
+    u32_t numOfFailures = getNumOfStoredResultsDiffs(cachedPtD, gepObjs, "'" + cacheFile + "'");
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "'" << cacheFile << "' holds the solved results\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " cached results differ from the solved ones\n";
 }
 
 /*!
@@ -95,6 +231,8 @@ void Andersen::initialize(SVFModule svfModule) {
     resetData();
     setDiffOpt(PtsDiff);
     setPWCOpt(MergePWC);
+    setWorklistStrategy(AnderWorkList);
+    setCheckTopoPriorities(CheckFixpoint);
     /// Build PAG
     PointerAnalysis::initialize(svfModule);
     /// Build Constraint Graph
@@ -107,6 +245,31 @@ void Andersen::initialize(SVFModule svfModule) {
     processAllAddr();
 }
 
+/*!
+ * Prioritise the nodes by their topological order for the TOPO and TWOPHASE
+ * worklists. processAllAddr has already filled the worklist, whose nodes are
+ * re-ordered by their priorities.
+ */
+void Andersen::initWorklist() {
+    updateTopoPriorities();
+}
+
+/*!
+ * Recompute the priorities of the TOPO and TWOPHASE worklists
+ */
+void Andersen::updateTopoPriorities() {
+    if (!isTopoWorklist())
+        return;
+
+    numOfSCCDetection++;
+    double sccStart = stat->getClk();
+    getSCCDetector()->find();
+    double sccEnd = stat->getClk();
+    timeOfSCCDetection += (sccEnd - sccStart) / TIMEINTERVAL;
+
+    setTopoPriorities(getSCCDetector()->topoNodeStack());
+}
+
 /*!
  * Start constraint solving
  */
@@ -127,6 +290,99 @@ void Andersen::processNode(NodeID nodeId) {
     timeOfProcessCopyGep += (propEnd - propStart) / TIMEINTERVAL;
 }
 
+/*!
+ * Finalize analysis
+ */
+void Andersen::finalize() {
+    /// dump constraint graph if PAGDotGraph flag is enabled
+    consCG->dump("consCG_final");
+    consCG->print();
+    /// sanitize field insensitive obj
+    /// TODO: Fields has been collapsed during Andersen::collapseField().
+    //	sanitizePts();
+
+    PointerAnalysis::finalize();
+
+    // Stride-based field representation has its own gep rules.
+    if (CheckFixpoint && getAnalysisTy() != AndersenSFR_WPA)
+        validateFixpointTests();
+}
+
+/*!
+ * Re-apply every constraint to the solved points-to sets, without updating
+ * them: whichever set would still grow means the solver stopped early.
+ * Fields of collapsed objects are replaced by their field-insensitive node,
+ * as collapseField does.
+ */
+void Andersen::validateFixpointTests() {
+    outs() << "[" << PTAName() << "] Checking the points-to sets are a fixpoint\n";
+
+    u32_t numOfFailures = 0;
+    auto check = [&](const PointsTo& from, const PointsTo& to, const char* what, NodeID nodeId) {
+        if (!to.contains(from) && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << what << " constraint of node " << nodeId << " is not solved\n";
+    };
+    auto collapsed = [&](NodeID obj) {
+        if (!consCG->isBlkObjOrConstantObj(obj) && consCG->isFieldInsensitiveObj(obj))
+            return consCG->getFIObjNode(obj);
+        return obj;
+    };
+
+    for (ConstraintGraph::const_iterator nodeIt = consCG->begin(), nodeEit = consCG->end(); nodeIt != nodeEit; nodeIt++) {
+        ConstraintNode* node = nodeIt->second;
+        NodeID nodeId = node->getId();
+        const PointsTo& pts = getPts(nodeId);
+
+        for (ConstraintNode::const_iterator it = node->incomingAddrsBegin(), eit = node->incomingAddrsEnd(); it != eit; ++it) {
+            PointsTo obj;
+            obj.set(collapsed((*it)->getSrcID()));
+            check(obj, pts, "address", nodeId);
+        }
+
+        for (ConstraintEdge* edge : node->getCopyOutEdges())
+            check(pts, getPts(edge->getDstID()), "copy", nodeId);
+
+        for (ConstraintEdge* edge : node->getGepOutEdges()) {
+            PointsTo fieldPts;
+            for (PointsTo::iterator piter = pts.begin(), epiter = pts.end(); piter != epiter; ++piter) {
+                NodeID ptd = *piter;
+                if (consCG->isBlkObjOrConstantObj(ptd))
+                    fieldPts.set(ptd);
+                else if (SVFUtil::isa<VariantGepCGEdge>(edge))
+                    fieldPts.set(consCG->getFIObjNode(ptd));
+                else if (const NormalGepCGEdge* normalGepEdge = SVFUtil::dyn_cast<NormalGepCGEdge>(edge)) {
+                    if (matchType(edge->getSrcID(), ptd, normalGepEdge))
+                        fieldPts.set(collapsed(consCG->getGepObjNode(ptd, normalGepEdge->getLocationSet())));
+                }
+            }
+            check(fieldPts, getPts(edge->getDstID()), "gep", nodeId);
+        }
+
+        for (PointsTo::iterator piter = pts.begin(), epiter = pts.end(); piter != epiter; ++piter) {
+            NodeID ptd = *piter;
+            if (pag->isConstantObj(ptd) || isNonPointerObj(ptd))
+                continue;
+            for (ConstraintNode::const_iterator it = node->outgoingLoadsBegin(), eit = node->outgoingLoadsEnd(); it != eit; ++it)
+                check(getPts(ptd), getPts((*it)->getDstID()), "load", nodeId);
+            for (ConstraintNode::const_iterator it = node->incomingStoresBegin(), eit = node->incomingStoresEnd(); it != eit; ++it)
+                check(getPts((*it)->getSrcID()), getPts(ptd), "store", nodeId);
+        }
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the points-to sets of " << consCG->getTotalNodeNum() << " constraint nodes are a fixpoint\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " points-to sets are not a fixpoint\n";
+
+    if (isTopoWorklist()) {
+        outs() << "[" << PTAName() << "] Checking the worklist priorities are topological\n";
+        if (getNumOfUntopoPriorities() == 0)
+            outs() << sucMsg("\t SUCCESS :") << "every SCC was prioritised before its successors\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << getNumOfUntopoPriorities() << " prioritisations are not topological\n";
+    }
+}
+
 /*!
  * Process copy and gep edges
  */
@@ -0,0 +1,318 @@
+//===- AndersenIncremental.cpp -- Re-solving Andersen's after module edits --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenIncremental.cpp
+ *
+ * The results written by -write-ander are accompanied by a ".deps" file
+ * giving, for each node, a key which survives edits of the module (node IDs
+ * do not) and the dependences between points-to sets found when solving.
+ * Given the functions edited since, the points-to sets which do not depend
+ * on them are mapped to the new nodes and seed the solver. This is a warm
+ * start, not a partial solve: the solver still runs over the whole new
+ * constraint graph, but begins from the seeded sets.
+ *
+ * The edits are assumed to be confined to the given functions: global
+ * initialisers and external summaries must be unchanged.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "WPA/Andersen.h"
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <fstream>
+#include <sstream>
+
+using namespace SVFUtil;
+
+/*!
+ * Instructions and arguments are identified by their position in their
+ * function, so the keys of the nodes of an unchanged function are stable.
+ */
+std::string Andersen::getStableNodeKey(const PAGNode* node, InstIndexMap& instIndices) const {
+    NodeID id = node->getId();
+    if (pag->isBlkObjOrConstantObj(id) || pag->isBlkPtr(id) || pag->isNullPtr(id))
+        return "#" + std::to_string(id);
+    // Dummy nodes are numbered in creation order, clones only exist in TBHC.
+    if (!node->hasValue() || SVFUtil::isa<CloneGepObjPN>(node) || SVFUtil::isa<CloneFIObjPN>(node))
+        return "";
+
+    std::string key = std::to_string(node->getNodeKind()) + ":";
+    const Value* value = node->getValue();
+    if (const Instruction* inst = SVFUtil::dyn_cast<Instruction>(value)) {
+        const Function* fun = inst->getParent()->getParent();
+        if (instIndices.find(inst) == instIndices.end()) {
+            u32_t index = 0;
+            for (const_inst_iterator it = inst_begin(fun), eit = inst_end(fun); it != eit; ++it)
+                instIndices[&*it] = index++;
+        }
+        key += fun->getName().str() + ":i" + std::to_string(instIndices[inst]);
+    } else if (const Argument* arg = SVFUtil::dyn_cast<Argument>(value)) {
+        key += arg->getParent()->getName().str() + ":a" + std::to_string(arg->getArgNo());
+    } else if (const GlobalValue* global = SVFUtil::dyn_cast<GlobalValue>(value)) {
+        if (!global->hasName())
+            return "";
+        key += global->getName().str();
+    } else {
+        return "";
+    }
+
+    if (const GepValPN* gep = SVFUtil::dyn_cast<GepValPN>(node))
+        key += "+" + std::to_string(gep->getOffset());
+    else if (const GepObjPN* gep = SVFUtil::dyn_cast<GepObjPN>(node))
+        key += "+" + std::to_string(gep->getLocationSet().getOffset());
+
+    if (key.find_first_of(" \t\n") != std::string::npos)
+        return "";
+    return key;
+}
+
+/*!
+ * Store a "ID rep function key" line per PAG node, where function is "-"
+ * for global nodes and "*" for nodes which can not be attributed to a
+ * function, then an "edges" line, then a "src dst" line per dependence of
+ * the points-to set of dst on that of src.
+ */
+void Andersen::writeDependencesToFile(const std::string& filename) {
+    outs() << "Storing dependences of pointer analysis results to '" << filename << "'...";
+
+    std::error_code err;
+    llvm::ToolOutputFile F(filename.c_str(), err, llvm::sys::fs::F_None);
+    if (err) {
+        outs() << "  error opening file for writing!\n";
+        F.os().clear_error();
+        return;
+    }
+    raw_ostream& os = F.os();
+
+    InstIndexMap instIndices;
+    for (PAG::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        const PAGNode* node = it->second;
+        std::string key = getStableNodeKey(node, instIndices);
+        std::string fun = "-";
+        if (!node->hasValue()) {
+            if (key.empty())
+                fun = "*";
+        } else if (const Function* f = node->getFunction()) {
+            fun = f->getName().str();
+        }
+        os << it->first << " " << sccRepNode(it->first) << " " << fun << " " << (key.empty() ? "-" : key) << "\n";
+    }
+
+    os << "edges\n";
+    for (ConstraintGraph::iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it) {
+        NodeID src = it->first;
+        ConstraintNode* node = it->second;
+        // Copy edges include those added for resolved loads, stores and calls.
+        for (ConstraintEdge* edge : node->getCopyOutEdges())
+            os << src << " " << edge->getDstID() << "\n";
+        for (ConstraintEdge* edge : node->getGepOutEdges())
+            os << src << " " << edge->getDstID() << "\n";
+        for (ConstraintEdge* edge : node->getLoadOutEdges())
+            os << src << " " << edge->getDstID() << "\n";
+        // The objects stored into depend on the pointer of a store.
+        if (!node->getStoreInEdges().empty()) {
+            const PointsTo& pts = getPts(src);
+            for (PointsTo::iterator pit = pts.begin(), epit = pts.end(); pit != epit; ++pit)
+                os << src << " " << *pit << "\n";
+        }
+    }
+
+    // The parameters of the callees of an indirect callsite depend on its function pointer.
+    const CallSiteToFunPtrMap& indCallsites = pag->getIndirectCallsites();
+    for (CallEdgeMap::const_iterator it = getIndCallMap().begin(), eit = getIndCallMap().end(); it != eit; ++it) {
+        CallSite cs = it->first;
+        CallSiteToFunPtrMap::const_iterator fpIt = indCallsites.find(cs);
+        if (fpIt == indCallsites.end())
+            continue;
+        NodeID funPtr = fpIt->second;
+        if (pag->callsiteHasRet(cs))
+            os << funPtr << " " << pag->getCallSiteRet(cs)->getId() << "\n";
+        for (FunctionSet::const_iterator fit = it->second.begin(), efit = it->second.end(); fit != efit; ++fit) {
+            const Function* callee = *fit;
+            if (pag->hasFunArgsMap(callee)) {
+                const PAG::PAGNodeList& funArgList = pag->getFunArgsList(callee);
+                for (PAG::PAGNodeList::const_iterator ait = funArgList.begin(), eait = funArgList.end(); ait != eait; ++ait)
+                    os << funPtr << " " << (*ait)->getId() << "\n";
+            }
+            if (callee->isVarArg())
+                os << funPtr << " " << pag->getVarargNode(callee) << "\n";
+        }
+    }
+
+    F.os().close();
+    if (!F.os().has_error()) {
+        outs() << "\n";
+        F.keep();
+    }
+}
+
+/*!
+ * The points-to sets affected by the changed functions are those reachable,
+ * through the stored dependences, from the nodes of these functions. The
+ * others are a subset of the new solution, so solving from them yields the
+ * same result as solving from scratch. They are only seeds: the caller still
+ * solves the whole constraint graph. Returns false, having seeded nothing,
+ * if the stored results can not be read.
+ */
+bool Andersen::readUnaffectedResults(const std::string& filename, const std::set<std::string>& changedFuns) {
+    outs() << "Loading unaffected pointer analysis results from '" << filename << "'...";
+
+    PTDataTy oldPtD;
+    StoredGepObjs gepObjs;
+    if (!parseResultsFile(filename, &oldPtD, gepObjs))
+        return false;
+
+    std::string depsFilename = filename + ".deps";
+    std::ifstream F(depsFilename.c_str());
+    if (!F.is_open()) {
+        outs() << "  error opening '" << depsFilename << "' for reading!\n";
+        return false;
+    }
+
+    // Read the nodes of the previous run
+    DenseMap<NodeID, NodeID> oldReps;
+    std::vector<std::pair<NodeID, std::string> > oldKeys;
+    NodeBS affected;
+    FIFOWorkList<NodeID> worklist;
+    std::string line;
+    while (std::getline(F, line) && line != "edges") {
+        std::istringstream ss(line);
+        NodeID id, rep;
+        std::string fun, key;
+        ss >> id >> rep >> fun >> key;
+        oldReps[id] = rep;
+        if (key != "-")
+            oldKeys.push_back(std::make_pair(id, key));
+        if ((fun == "*" || changedFuns.count(fun)) && !affected.test(rep)) {
+            affected.set(rep);
+            worklist.push(rep);
+        }
+    }
+
+    // Read the dependences between the rep nodes of the previous run
+    auto oldRep = [&oldReps](NodeID id) {
+        DenseMap<NodeID, NodeID>::const_iterator it = oldReps.find(id);
+        return it == oldReps.end() ? id : it->second;
+    };
+    DenseMap<NodeID, NodeVector> dependents;
+    while (std::getline(F, line)) {
+        std::istringstream ss(line);
+        NodeID src, dst;
+        if (ss >> src >> dst)
+            dependents[oldRep(src)].push_back(oldRep(dst));
+    }
+    F.close();
+
+    while (!worklist.empty()) {
+        NodeID rep = worklist.pop();
+        DenseMap<NodeID, NodeVector>::const_iterator it = dependents.find(rep);
+        if (it == dependents.end())
+            continue;
+        for (NodeID dst : it->second) {
+            if (!affected.test(dst)) {
+                affected.set(dst);
+                worklist.push(dst);
+            }
+        }
+    }
+
+    // Map the nodes of the previous run to the current ones by their keys.
+    // A key shared by several nodes identifies none of them.
+    InstIndexMap instIndices;
+    std::map<std::string, NodeID> keyToNode;
+    std::set<std::string> ambiguousKeys;
+    for (PAG::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it) {
+        std::string key = getStableNodeKey(it->second, instIndices);
+        if (!key.empty() && !keyToNode.insert(std::make_pair(key, it->first)).second)
+            ambiguousKeys.insert(key);
+    }
+
+    DenseMap<NodeID, NodeID> oldToNew;
+    for (const std::pair<NodeID, std::string>& oldKey : oldKeys) {
+        std::map<std::string, NodeID>::const_iterator it = keyToNode.find(oldKey.second);
+        if (it != keyToNode.end() && !ambiguousKeys.count(oldKey.second))
+            oldToNew[oldKey.first] = it->second;
+    }
+    // Field objects were created while solving, so they are created again.
+    for (const StoredGepObj& gepObj : gepObjs) {
+        DenseMap<NodeID, NodeID>::const_iterator it = oldToNew.find(gepObj.base);
+        if (it != oldToNew.end())
+            oldToNew[gepObj.id] = consCG->getGepObjNode(it->second, LocationSet(gepObj.offset));
+    }
+
+    // Seed the unaffected points-to sets
+    u32_t numOfSeeded = 0;
+    for (PTDataTy::PtsMapConstIter it = oldPtD.getPtsMap().begin(), eit = oldPtD.getPtsMap().end(); it != eit; ++it) {
+        if (affected.test(oldRep(it->first)))
+            continue;
+        DenseMap<NodeID, NodeID>::const_iterator nit = oldToNew.find(it->first);
+        if (nit == oldToNew.end())
+            continue;
+
+        PointsTo pts;
+        for (PointsTo::iterator pit = it->second.begin(), epit = it->second.end(); pit != epit; ++pit) {
+            DenseMap<NodeID, NodeID>::const_iterator oit = oldToNew.find(*pit);
+            if (oit != oldToNew.end())
+                pts.set(oit->second);
+        }
+        if (!pts.empty() && unionPts(nit->second, pts)) {
+            pushIntoWorklist(sccRepNode(nit->second));
+            numOfSeeded++;
+        }
+    }
+
+    outs() << "  " << numOfSeeded << " points-to sets reused, "
+           << affected.count() << " nodes affected\n";
+    return true;
+}
+
+/*!
+ * Solve the constraints again from scratch, by plain Andersen's analysis on
+ * its own constraint graph, and compare its points-to sets with the seeded
+ * ones: a seed depending on a changed function makes them larger.
+ * The results of the stride-based and type-filtered analyses are not those
+ * of plain Andersen's analysis, so these are not checked.
+ */
+void Andersen::validateIncrementalTests(SVFModule svfModule) {
+    if (getAnalysisTy() == AndersenSFR_WPA || getAnalysisTy() == AndersenWaveDiffWithType_WPA)
+        return;
+
+    outs() << "[" << PTAName() << "] Checking the seeded results are the ones of solving from scratch\n";
+
+    Andersen scratch;
+    scratch.initialize(svfModule);
+    scratch.solve();
+
+    u32_t numOfFailures = 0;
+    for (ConstraintGraph::iterator it = consCG->begin(), eit = consCG->end(); it != eit; ++it) {
+        NodeID id = it->first;
+        if (getPts(id) != scratch.getPts(id) && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << "points-to set of node " << id << " differs from the one solved from scratch\n";
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the points-to sets of " << consCG->getTotalNodeNum() << " constraint nodes are the ones solved from scratch\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " points-to sets differ from the ones solved from scratch\n";
+}
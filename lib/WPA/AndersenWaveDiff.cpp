@@ -42,14 +42,7 @@ void AndersenWaveDiff::solveWorklist() {
     NodeStack& nodeStack = SCCDetect();
 
     // Process nodeStack and put the changed nodes into workList.
-    while (!nodeStack.empty()) {
-        NodeID nodeId = nodeStack.top();
-        nodeStack.pop();
-        collapsePWCNode(nodeId);
-        // process nodes in nodeStack
-        processNode(nodeId);
-        collapseFields();
-    }
+    processNodeStack(nodeStack);
 
     // This modification is to make WAVE feasible to handle PWC analysis
     if (!mergePWC()) {
@@ -70,6 +63,27 @@ void AndersenWaveDiff::solveWorklist() {
     }
 
     // New nodes will be inserted into workList during processing.
+    postProcessWorklist();
+}
+
+/*!
+ * Propagate points-to along copy/gep edges in the topological order of nodeStack
+ */
+void AndersenWaveDiff::processNodeStack(NodeStack& nodeStack) {
+    while (!nodeStack.empty()) {
+        NodeID nodeId = nodeStack.top();
+        nodeStack.pop();
+        collapsePWCNode(nodeId);
+        // process nodes in nodeStack
+        processNode(nodeId);
+        collapseFields();
+    }
+}
+
+/*!
+ * Handle load/store edges of the nodes in the worklist until it is empty
+ */
+void AndersenWaveDiff::postProcessWorklist() {
     while (!isWorklistEmpty()) {
         NodeID nodeId = popFromWorklist();
         // process nodes in worklist
@@ -0,0 +1,277 @@
+//===- AndersenWaveDiffParallel.cpp -- Diff wave propagation on threads -----//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * AndersenWaveDiffParallel.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "WPA/Andersen.h"
+#include "Util/Parallel.h"
+
+using namespace SVFUtil;
+
+/*!
+ * Process the nodes of nodeStack wave by wave
+ */
+void AndersenWaveDiffParallel::processNodeStack(NodeStack& nodeStack) {
+    Waves waves;
+    computeWaves(nodeStack, waves);
+    for (Waves::const_iterator it = waves.begin(), eit = waves.end(); it != eit; ++it)
+        processWave(*it);
+}
+
+/*!
+ * Handle load/store edges of the nodes in the worklist, one batch at a time,
+ * until no new nodes are pushed into the worklist
+ */
+void AndersenWaveDiffParallel::postProcessWorklist() {
+    while (!isWorklistEmpty()) {
+        NodeVector nodes;
+        while (!isWorklistEmpty())
+            nodes.push_back(popFromWorklist());
+        processLoadsAndStores(nodes);
+    }
+}
+
+/*!
+ * A node's wave is the length of the longest path reaching it through
+ * copy/gep edges, so no two nodes of a wave are connected by those edges.
+ */
+void AndersenWaveDiffParallel::computeWaves(NodeStack& nodeStack, Waves& waves) {
+    DenseMap<NodeID, u32_t> nodeToWave;
+    while (!nodeStack.empty()) {
+        NodeID nodeId = nodeStack.top();
+        nodeStack.pop();
+
+        u32_t wave = nodeToWave[nodeId];
+        if (wave >= waves.size())
+            waves.resize(wave + 1);
+        waves[wave].push_back(nodeId);
+
+        ConstraintNode* node = consCG->getConstraintNode(nodeId);
+        for (ConstraintEdge* edge : node->getCopyOutEdges()) {
+            NodeID dst = sccRepNode(edge->getDstID());
+            if (dst != nodeId && nodeToWave[dst] < wave + 1)
+                nodeToWave[dst] = wave + 1;
+        }
+        for (ConstraintEdge* edge : node->getGepOutEdges()) {
+            NodeID dst = sccRepNode(edge->getDstID());
+            if (dst != nodeId && nodeToWave[dst] < wave + 1)
+                nodeToWave[dst] = wave + 1;
+        }
+    }
+}
+
+/*!
+ * Propagate the diff points-to of the nodes of a wave along their copy and
+ * gep edges
+ */
+void AndersenWaveDiffParallel::processWave(const NodeVector& wave) {
+    for (NodeVector::const_iterator it = wave.begin(), eit = wave.end(); it != eit; ++it)
+        collapsePWCNode(*it);
+
+    double propStart = stat->getClk();
+
+    // Nodes may have been merged by the collapsing above. Only rep nodes need to be handled.
+    NodeVector reps;
+    NodeBS inWave;
+    for (NodeVector::const_iterator it = wave.begin(), eit = wave.end(); it != eit; ++it) {
+        if (sccRepNode(*it) == *it && !inWave.test(*it)) {
+            reps.push_back(*it);
+            inWave.set(*it);
+        }
+    }
+
+    // Look the sets up first: the maps holding them must not be modified
+    // while other threads read them.
+    u32_t numOfReps = reps.size();
+    std::vector<PointsTo*> pts(numOfReps), diffPts(numOfReps), propaPts(numOfReps);
+    for (u32_t i = 0; i < numOfReps; ++i) {
+        pts[i] = &getPTDataTy()->getPts(reps[i]);
+        if (enableDiff()) {
+            diffPts[i] = &getDiffPTDataTy()->getDiffPts(reps[i]);
+            propaPts[i] = &getDiffPTDataTy()->getPropaPts(reps[i]);
+        } else {
+            diffPts[i] = pts[i];
+        }
+    }
+
+    u32_t numOfWorkers = getNumOfPtsWorkers();
+    if (enableDiff()) {
+        parallelFor(0, numOfReps, [&](u32_t i) {
+            DiffPTDataTy::computeDiffPts(*diffPts[i], *propaPts[i], *pts[i]);
+        }, numOfWorkers);
+    }
+
+    // Gep edges may create field objects, so they are processed sequentially.
+    // Copy edges are collected as (dst, index of src) and processed below.
+    std::vector<std::pair<NodeID, u32_t> > copies;
+    std::vector<std::pair<NodeID, const CopyCGEdge*> > inWaveCopies;
+    for (u32_t i = 0; i < numOfReps; ++i) {
+        if (diffPts[i]->empty())
+            continue;
+
+        NodeID nodeId = reps[i];
+        ConstraintNode* node = consCG->getConstraintNode(nodeId);
+        for (ConstraintEdge* edge : node->getCopyOutEdges()) {
+            if (CopyCGEdge* copyEdge = SVFUtil::dyn_cast<CopyCGEdge>(edge)) {
+                NodeID dst = sccRepNode(copyEdge->getDstID());
+                if (inWave.test(dst))
+                    inWaveCopies.push_back(std::make_pair(nodeId, copyEdge));
+                else {
+                    numOfProcessedCopy++;
+                    processCast(copyEdge);
+                    copies.push_back(std::make_pair(dst, i));
+                }
+            }
+        }
+        for (ConstraintEdge* edge : node->getGepOutEdges())
+            if (GepCGEdge* gepEdge = SVFUtil::dyn_cast<GepCGEdge>(edge))
+                processGep(nodeId, gepEdge);
+    }
+
+    // Each destination is handled by one thread which unions all its sources.
+    std::sort(copies.begin(), copies.end());
+    NodeVector dsts;
+    std::vector<u32_t> dstBegins;
+    for (u32_t i = 0; i < copies.size(); ++i) {
+        if (dsts.empty() || dsts.back() != copies[i].first) {
+            dsts.push_back(copies[i].first);
+            dstBegins.push_back(i);
+        }
+    }
+    dstBegins.push_back(copies.size());
+
+    u32_t numOfDsts = dsts.size();
+    std::vector<PointsTo*> dstPts(numOfDsts);
+    for (u32_t d = 0; d < numOfDsts; ++d)
+        dstPts[d] = &getPTDataTy()->getPts(dsts[d]);
+
+    std::vector<char> changed(numOfDsts, false);
+    parallelFor(0, numOfDsts, [&](u32_t d) {
+        for (u32_t c = dstBegins[d]; c < dstBegins[d + 1]; ++c) {
+            if (*dstPts[d] |= *diffPts[copies[c].second])
+                changed[d] = true;
+        }
+    }, numOfWorkers);
+
+    // Reverse points-to and the worklist are shared, so update them sequentially.
+    for (u32_t d = 0; d < numOfDsts; ++d) {
+        for (u32_t c = dstBegins[d]; c < dstBegins[d + 1]; ++c)
+            getPTDataTy()->addRevPts(*diffPts[copies[c].second], dsts[d]);
+        if (changed[d])
+            pushIntoWorklist(dsts[d]);
+    }
+
+    // Merged nodes may have copy edges to nodes of the same wave.
+    for (u32_t i = 0; i < inWaveCopies.size(); ++i)
+        processCopy(inWaveCopies[i].first, inWaveCopies[i].second);
+
+    double propEnd = stat->getClk();
+    timeOfProcessCopyGep += (propEnd - propStart) / TIMEINTERVAL;
+
+    collapseFields();
+}
+
+/*!
+ * Handle load/store edges of nodes. New copy edges are found in parallel and
+ * added to the constraint graph sequentially. As for the edges of a wave, the
+ * points-to of their sources reach their destinations by diff propagation:
+ * addCopyEdge only keeps in the propagated set of a source what its new
+ * destination already has, and reanalyze makes the next waves propagate
+ * the rest.
+ */
+void AndersenWaveDiffParallel::processLoadsAndStores(const NodeVector& nodes) {
+    double insertStart = stat->getClk();
+
+    u32_t numOfNodes = nodes.size();
+    std::vector<PointsTo*> pts(numOfNodes);
+    for (u32_t i = 0; i < numOfNodes; ++i) {
+        pts[i] = &getPts(nodes[i]);
+        ConstraintNode* node = consCG->getConstraintNode(nodes[i]);
+        if (node->outgoingLoadsBegin() != node->outgoingLoadsEnd()
+                || node->incomingStoresBegin() != node->incomingStoresEnd())
+            markSkippedObjs(*pts[i]);
+    }
+
+    // Candidate copy edges (src, dst) of each node.
+    std::vector<std::vector<NodePair> > candidates(numOfNodes);
+    std::vector<Size_t> numOfLoads(numOfNodes, 0), numOfStores(numOfNodes, 0);
+    u32_t numOfWorkers = getNumOfPtsWorkers();
+    parallelFor(0, numOfNodes, [&](u32_t i) {
+        ConstraintNode* node = consCG->getConstraintNode(nodes[i]);
+        for (ConstraintNode::const_iterator it = node->outgoingLoadsBegin(), eit = node->outgoingLoadsEnd();
+                it != eit; ++it) {
+            for (PointsTo::iterator piter = pts[i]->begin(), epiter = pts[i]->end(); piter != epiter; ++piter) {
+                if (skippedObjs.test(*piter))
+                    continue;
+                numOfLoads[i]++;
+                candidates[i].push_back(std::make_pair(*piter, (*it)->getDstID()));
+            }
+        }
+        for (ConstraintNode::const_iterator it = node->incomingStoresBegin(), eit = node->incomingStoresEnd();
+                it != eit; ++it) {
+            for (PointsTo::iterator piter = pts[i]->begin(), epiter = pts[i]->end(); piter != epiter; ++piter) {
+                if (skippedObjs.test(*piter))
+                    continue;
+                numOfStores[i]++;
+                candidates[i].push_back(std::make_pair((*it)->getSrcID(), *piter));
+            }
+        }
+    }, numOfWorkers);
+
+    // Add the new edges in a deterministic order.
+    for (u32_t i = 0; i < numOfNodes; ++i) {
+        numOfProcessedLoad += numOfLoads[i];
+        numOfProcessedStore += numOfStores[i];
+        for (std::vector<NodePair>::const_iterator it = candidates[i].begin(), eit = candidates[i].end(); it != eit; ++it) {
+            if (Andersen::addCopyEdge(it->first, it->second))
+                reanalyze = true;
+        }
+    }
+
+    double insertEnd = stat->getClk();
+    timeOfProcessLoadStore += (insertEnd - insertStart) / TIMEINTERVAL;
+}
+
+/*!
+ * Record which objects of pts loads and stores skip (constant and
+ * non-pointer objects). isNonPointerObj may add to the struct info of
+ * SymbolTableInfo, so this is done before the threads of
+ * processLoadsAndStores start, which then only read skippedObjs.
+ */
+void AndersenWaveDiffParallel::markSkippedObjs(const PointsTo& pts) {
+    for (PointsTo::iterator it = pts.begin(), eit = pts.end(); it != eit; ++it) {
+        NodeID obj = *it;
+        if (obj >= checkedObjs.size()) {
+            checkedObjs.resize(obj + 1);
+            skippedObjs.resize(obj + 1);
+        }
+        if (checkedObjs.test(obj))
+            continue;
+        checkedObjs.set(obj);
+        if (pag->isConstantObj(obj) || isNonPointerObj(obj))
+            skippedObjs.set(obj);
+    }
+}
@@ -29,12 +29,27 @@
 
 #include "MemoryModel/DCHG.h"
 #include "Util/SVFModule.h"
+#include "Util/Parallel.h"
 #include "Util/TypeBasedHeapCloning.h"
 #include "WPA/WPAStat.h"
 #include "WPA/FlowSensitive.h"
 #include "WPA/Andersen.h"
 
 static llvm::cl::opt<bool> CTirAliasEval("ctir-alias-eval", llvm::cl::init(false), llvm::cl::desc("Prints alias evaluation of ctir instructions in FS analyses"));
+static llvm::cl::opt<bool> CheckCTirAliasEval("ctir-check-alias-eval", llvm::cl::init(false), llvm::cl::desc("Check the alias counts of -ctir-alias-eval against calling alias on every pair"));
+static llvm::cl::opt<WPASVFGFSSolver::WorkList::Strategy> FSWorkList("fs-worklist",
+        llvm::cl::init(WPASVFGFSSolver::WorkList::FIFO),
+        llvm::cl::desc("Worklist order of flow-sensitive analyses"),
+        llvm::cl::values(
+            clEnumValN(WPASVFGFSSolver::WorkList::FIFO, "fifo", "First in first out"),
+            clEnumValN(WPASVFGFSSolver::WorkList::LRF, "lrf", "Least recently fired first"),
+            clEnumValN(WPASVFGFSSolver::WorkList::TOPO, "topo", "Topological order first"),
+            clEnumValN(WPASVFGFSSolver::WorkList::TWOPHASE, "2phase", "Two phases, each in topological order")
+        ));
+static llvm::cl::opt<bool> CompactSVFG("fs-compact-svfg", llvm::cl::init(false), llvm::cl::desc("Propagate along a compacted (CSR) copy of the SVFG out edges in flow-sensitive analyses; faster iteration for extra memory"));
+static llvm::cl::opt<bool> CheckFixpoint("fs-check-fixpoint", llvm::cl::init(false), llvm::cl::desc("Check that the solved points-to sets of the flow-sensitive analysis are a fixpoint of its SVFG nodes and edges, that compacted SVFG edges are up to date, and that topo worklists were prioritised topologically"));
+static llvm::cl::opt<bool> CheckParallelDFInUnion("fs-check-parallel-in-union", llvm::cl::init(false), llvm::cl::desc("Check the unions into IN sets done on several threads by -fs-parallel-in-union against the same unions done on one thread"));
+static llvm::cl::opt<bool> ParallelDFInUnion("fs-parallel-in-union", llvm::cl::init(false), llvm::cl::desc("Apply the unions into IN sets of flow-sensitive analyses on several threads (see -svf-threads); nodes are still processed on one thread"));
 
 using namespace SVFUtil;
 
@@ -50,6 +65,8 @@ void FlowSensitive::initialize(SVFModule svfModule) {
     // When evaluating ctir aliases, we want the whole SVFG.
     svfg = CTirAliasEval ? memSSA.buildFullSVFG(ander) : memSSA.buildPTROnlySVFG(ander);
     setGraph(svfg);
+    if (CompactSVFG)
+        svfg->compactOutEdges();
     //AndersenWaveDiff::releaseAndersenWaveDiff();
 
     stat = new FlowSensitiveStat(this);
@@ -59,6 +76,8 @@ void FlowSensitive::initialize(SVFModule svfModule) {
  * Start analysis
  */
 void FlowSensitive::analyze(SVFModule svfModule) {
+    setWorklistStrategy(FSWorkList);
+    setCheckTopoPriorities(CheckFixpoint);
     /// Initialization for the Solver
     initialize(svfModule);
 
@@ -108,12 +127,157 @@ void FlowSensitive::finalize()
     }
 
     PointerAnalysis::finalize();
+    // Type-based heap cloning filters what it propagates, so only plain FS
+    // has to be a fixpoint of the unfiltered transfer functions.
+    if (CheckFixpoint && getAnalysisTy() == FSSPARSE_WPA)
+        validateFixpointTests();
     printCallGraphStats();
     if (CTirAliasEval) {
         printCTirAliasStats();
     }
 }
 
+/*!
+ * Re-apply the transfer function of every SVFG node and edge to the solved
+ * points-to sets, without updating them: whichever set would still grow
+ * means the solver stopped early.
+ */
+void FlowSensitive::validateFixpointTests() {
+    outs() << "[" << PTAName() << "] Checking the points-to sets are a fixpoint\n";
+
+    u32_t numOfFailures = 0;
+    auto check = [&](const PointsTo& from, const PointsTo& to, const char* what, NodeID nodeId) {
+        if (!to.contains(from) && numOfFailures++ < 10)
+            SVFUtil::errs() << errMsg("\t FAIL :") << what << " at SVFG node " << nodeId << " is not propagated\n";
+    };
+
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it) {
+        const SVFGNode* node = it->second;
+        NodeID id = node->getId();
+
+        if (const AddrSVFGNode* addr = SVFUtil::dyn_cast<AddrSVFGNode>(node)) {
+            NodeID srcID = addr->getPAGSrcNodeID();
+            if (isFieldInsensitive(srcID))
+                srcID = getFIObjNode(srcID);
+            PointsTo obj;
+            obj.set(srcID);
+            check(obj, getPts(addr->getPAGDstNodeID()), "address", id);
+        }
+        else if (const CopySVFGNode* copy = SVFUtil::dyn_cast<CopySVFGNode>(node)) {
+            check(getPts(copy->getPAGSrcNodeID()), getPts(copy->getPAGDstNodeID()), "copy", id);
+        }
+        else if (const PHISVFGNode* phi = SVFUtil::dyn_cast<PHISVFGNode>(node)) {
+            for (PHISVFGNode::OPVers::const_iterator oit = phi->opVerBegin(), eoit = phi->opVerEnd(); oit != eoit; ++oit)
+                check(getPts(oit->second->getId()), getPts(phi->getRes()->getId()), "phi", id);
+        }
+        else if (const GepSVFGNode* gep = SVFUtil::dyn_cast<GepSVFGNode>(node)) {
+            PointsTo fieldPts;
+            const PointsTo& srcPts = getPts(gep->getPAGSrcNodeID());
+            for (PointsTo::iterator pit = srcPts.begin(), epit = srcPts.end(); pit != epit; ++pit) {
+                if (isBlkObjOrConstantObj(*pit))
+                    fieldPts.set(*pit);
+                else if (SVFUtil::isa<VariantGepPE>(gep->getPAGEdge()))
+                    fieldPts.set(getFIObjNode(*pit));
+                else if (const NormalGepPE* normalGep = SVFUtil::dyn_cast<NormalGepPE>(gep->getPAGEdge()))
+                    fieldPts.set(getGepObjNode(*pit, normalGep->getLocationSet()));
+            }
+            check(fieldPts, getPts(gep->getPAGDstNodeID()), "gep", id);
+        }
+        else if (const LoadSVFGNode* load = SVFUtil::dyn_cast<LoadSVFGNode>(node)) {
+            const PointsTo& srcPts = getPts(load->getPAGSrcNodeID());
+            const PointsTo& dstPts = getPts(load->getPAGDstNodeID());
+            for (PointsTo::iterator pit = srcPts.begin(), epit = srcPts.end(); pit != epit; ++pit) {
+                if (pag->isConstantObj(*pit) || pag->isNonPointerObj(*pit))
+                    continue;
+                check(getDFInPtsSet(load, *pit), dstPts, "load", id);
+                if (isFIObjNode(*pit)) {
+                    const NodeBS& allFields = getAllFieldsObjNode(*pit);
+                    for (NodeBS::iterator fit = allFields.begin(), efit = allFields.end(); fit != efit; ++fit)
+                        check(getDFInPtsSet(load, *fit), dstPts, "load", id);
+                }
+            }
+        }
+        else if (const StoreSVFGNode* store = SVFUtil::dyn_cast<StoreSVFGNode>(node)) {
+            // A store with an empty pointer has not been processed at all.
+            const PointsTo& dstPts = getPts(store->getPAGDstNodeID());
+            if (!dstPts.empty()) {
+                NodeID singleton = 0;
+                bool isSU = isStrongUpdate(store, singleton);
+                NodeBS inVars;
+                getDFPTDataTy()->getDFInVars(id, inVars);
+                for (NodeBS::iterator vit = inVars.begin(), evit = inVars.end(); vit != evit; ++vit) {
+                    if (!isSU || *vit != singleton)
+                        check(getDFInPtsSet(store, *vit), getDFOutPtsSet(store, *vit), "store IN to OUT", id);
+                }
+
+                const PointsTo& srcPts = getPts(store->getPAGSrcNodeID());
+                for (PointsTo::iterator pit = dstPts.begin(), epit = dstPts.end(); pit != epit; ++pit) {
+                    if (pag->isConstantObj(*pit) || pag->isNonPointerObj(*pit))
+                        continue;
+                    check(srcPts, getDFOutPtsSet(store, *pit), "store", id);
+                }
+            }
+        }
+
+        for (SVFGNode::const_iterator eit = node->OutEdgeBegin(), eeit = node->OutEdgeEnd(); eit != eeit; ++eit) {
+            const SVFGEdge* edge = *eit;
+            const SVFGNode* dst = edge->getDstNode();
+            if (const IndirectSVFGEdge* indEdge = SVFUtil::dyn_cast<IndirectSVFGEdge>(edge)) {
+                const PointsTo& edgePts = indEdge->getPointsTo();
+                for (PointsTo::iterator pit = edgePts.begin(), epit = edgePts.end(); pit != epit; ++pit) {
+                    NodeBS vars;
+                    vars.set(*pit);
+                    if (isFIObjNode(*pit))
+                        vars |= getAllFieldsObjNode(*pit);
+                    for (NodeBS::iterator vit = vars.begin(), evit = vars.end(); vit != evit; ++vit) {
+                        const PointsTo& srcPts = SVFUtil::isa<StoreSVFGNode>(node)
+                                                 ? getDFOutPtsSet(node, *vit) : getDFInPtsSet(node, *vit);
+                        check(srcPts, getDFInPtsSet(dst, *vit), "indirect edge", id);
+                    }
+                }
+            }
+            else if (const ActualParmSVFGNode* ap = SVFUtil::dyn_cast<ActualParmSVFGNode>(node)) {
+                if (const FormalParmSVFGNode* fp = SVFUtil::dyn_cast<FormalParmSVFGNode>(dst))
+                    check(getPts(ap->getParam()->getId()), getPts(fp->getParam()->getId()), "parameter", id);
+            }
+            else if (const FormalRetSVFGNode* fr = SVFUtil::dyn_cast<FormalRetSVFGNode>(node)) {
+                if (const ActualRetSVFGNode* ar = SVFUtil::dyn_cast<ActualRetSVFGNode>(dst))
+                    check(getPts(fr->getRet()->getId()), getPts(ar->getRev()->getId()), "return", id);
+            }
+        }
+    }
+
+    // The flat store is looked up by binary search, so its rows must stay sorted.
+    if (const FlatDFPTDataTy* flat = SVFUtil::dyn_cast<FlatDFPTDataTy>(getDFPTDataTy())) {
+        if (u32_t numOfBrokenRows = flat->getNumOfBrokenRows()) {
+            SVFUtil::errs() << errMsg("\t FAIL :") << numOfBrokenRows << " IN/OUT rows of the flat store are broken\n";
+            numOfFailures += numOfBrokenRows;
+        }
+    }
+
+    if (numOfFailures == 0)
+        outs() << sucMsg("\t SUCCESS :") << "the points-to sets of " << svfg->getTotalNodeNum() << " SVFG nodes are a fixpoint\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << numOfFailures << " points-to sets are not a fixpoint\n";
+
+    if (CompactSVFG) {
+        outs() << "[" << PTAName() << "] Checking the compacted SVFG out edges are up to date\n";
+        u32_t numOfStale = svfg->getNumOfStaleCompactOutEdges();
+        if (numOfStale == 0)
+            outs() << sucMsg("\t SUCCESS :") << "the compacted out edges are the edge sets of their nodes\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << numOfStale << " nodes have stale compacted out edges\n";
+    }
+
+    if (isTopoWorklist()) {
+        outs() << "[" << PTAName() << "] Checking the worklist priorities are topological\n";
+        if (getNumOfUntopoPriorities() == 0)
+            outs() << sucMsg("\t SUCCESS :") << "every SCC was prioritised before its successors\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << getNumOfUntopoPriorities() << " prioritisations are not topological\n";
+    }
+}
+
 /*!
  * SCC detection
  */
@@ -126,6 +290,50 @@ NodeStack& FlowSensitive::SCCDetect()
     return nodeStack;
 }
 
+/*!
+ * Solve the worklist.
+ * With -fs-parallel-in-union, it is solved in rounds: the nodes in the
+ * worklist are processed one by one while the unions into IN sets along
+ * indirect edges are deferred, then the deferred unions are applied on
+ * several threads and the nodes whose IN set changed make up the next
+ * round. Only this IN-set union phase is parallel.
+ */
+void FlowSensitive::solveWorklist() {
+    if (!ParallelDFInUnion) {
+        WPASVFGFSSolver::solveWorklist();
+        return;
+    }
+
+    u32_t numOfThreads = SVFUtil::getNumOfPtsWorkers();
+    u32_t numOfMismatches = 0;
+
+    while (!isWorklistEmpty()) {
+        NodeVector nodes;
+        while (!isWorklistEmpty())
+            nodes.push_back(popFromWorklist());
+
+        getDFPTDataTy()->beginDFInUpdates();
+        for (NodeVector::const_iterator it = nodes.begin(), eit = nodes.end(); it != eit; ++it)
+            processNode(*it);
+
+        double start = stat->getClk();
+        NodeBS changedLocs;
+        numOfMismatches += getDFPTDataTy()->commitDFInUpdates(changedLocs, numOfThreads, CheckParallelDFInUnion);
+        for (NodeBS::iterator it = changedLocs.begin(), eit = changedLocs.end(); it != eit; ++it)
+            pushIntoWorklist(*it);
+        double end = stat->getClk();
+        indirectPropaTime += (end - start) / TIMEINTERVAL;
+    }
+
+    if (CheckParallelDFInUnion) {
+        outs() << "[" << PTAName() << "] Checking the unions into IN sets done on " << numOfThreads << " threads\n";
+        if (numOfMismatches == 0)
+            outs() << sucMsg("\t SUCCESS :") << "the IN sets are the ones of unions done on one thread\n";
+        else
+            SVFUtil::errs() << errMsg("\t FAIL :") << numOfMismatches << " IN sets differ from unions done on one thread\n";
+    }
+}
+
 /*!
  * Process each SVFG node
  */
@@ -137,6 +345,22 @@ void FlowSensitive::processNode(NodeID nodeId) {
     clearAllDFOutVarFlag(node);
 }
 
+/*!
+ * Propagate along the out edges of a node, through the compacted out edges
+ * of the SVFG when they are up to date
+ */
+void FlowSensitive::propagate(SVFGNode** v) {
+    u32_t begin, end;
+    if (!svfg->getCompactOutEdges(*v, begin, end)) {
+        WPASVFGFSSolver::propagate(v);
+        return;
+    }
+    for (u32_t i = begin; i < end; ++i) {
+        if (propFromSrcToDst(svfg->getCompactEdge(i)))
+            pushIntoWorklist(svfg->getCompactDstID(i));
+    }
+}
+
 /*!
  * Process each SVFG node
  */
@@ -638,6 +862,25 @@ void FlowSensitive::printCTirAliasStats(void) {
 
     // < SVFG node ID (loc), PAG node of interest (top-level pointer) >.
     std::set<std::pair<NodeID, NodeID>> cmpLocs;
+    collectCTirAliasLocs(cmpLocs);
+
+    unsigned mayAliases = 0, noAliases = 0;
+    countAliases(cmpLocs, &mayAliases, &noAliases);
+
+    unsigned total = mayAliases + noAliases;
+    llvm::outs() << "eval-ctir-aliases "
+                 << total << " "
+                 << mayAliases << " "
+                 << noAliases << " "
+                 << "\n";
+    llvm::outs() << "  " << "TOTAL : " << total << "\n"
+                 << "  " << "MAY   : " << mayAliases << "\n"
+                 << "  " << "MAY % : " << 100 * ((double)mayAliases/(double)(total)) << "\n"
+                 << "  " << "NO    : " << noAliases << "\n"
+                 << "  " << "NO  % : " << 100 * ((double)noAliases/(double)(total)) << "\n";
+}
+
+void FlowSensitive::collectCTirAliasLocs(std::set<std::pair<NodeID, NodeID>> &cmpLocs) {
     for (SVFG::iterator npair = svfg->begin(); npair != svfg->end(); ++npair) {
         NodeID loc = npair->first;
         SVFGNode *node = npair->second;
@@ -668,43 +911,195 @@ void FlowSensitive::printCTirAliasStats(void) {
             cmpLocs.insert(std::make_pair(loc, p));
         }
     }
+}
 
-    unsigned mayAliases = 0, noAliases = 0;
-    countAliases(cmpLocs, &mayAliases, &noAliases);
+void FlowSensitive::countAliases(std::set<std::pair<NodeID, NodeID>> cmp, unsigned *mayAliases, unsigned *noAliases) {
+    // loc doesn't make a difference for FSPTA, so the locations of a pointer
+    // are one entry standing for all of them.
+    std::map<NodeID, u64_t> ptrToNumOfLocs;
+    for (std::pair<NodeID, NodeID> locP : cmp) {
+        ++ptrToNumOfLocs[locP.second];
+    }
 
-    unsigned total = mayAliases + noAliases;
-    llvm::outs() << "eval-ctir-aliases "
-                 << total << " "
-                 << mayAliases << " "
-                 << noAliases << " "
-                 << "\n";
-    llvm::outs() << "  " << "TOTAL : " << total << "\n"
-                 << "  " << "MAY   : " << mayAliases << "\n"
-                 << "  " << "MAY % : " << 100 * ((double)mayAliases/(double)(total)) << "\n"
-                 << "  " << "NO    : " << noAliases << "\n"
-                 << "  " << "NO  % : " << 100 * ((double)noAliases/(double)(total)) << "\n";
+    std::vector<const PointsTo *> ptsList;
+    std::vector<u64_t> weights;
+    for (std::map<NodeID, u64_t>::const_iterator it = ptrToNumOfLocs.begin(), eit = ptrToNumOfLocs.end(); it != eit; ++it) {
+        ptsList.push_back(&getPts(it->first));
+        weights.push_back(it->second);
+    }
+
+    countAliases(ptsList, weights, mayAliases, noAliases);
 }
 
-void FlowSensitive::countAliases(std::set<std::pair<NodeID, NodeID>> cmp, unsigned *mayAliases, unsigned *noAliases) {
-    for (std::pair<NodeID, NodeID> locPA : cmp) {
-        // loc doesn't make a difference for FSPTA.
-        NodeID p = locPA.second;
-        for (std::pair<NodeID, NodeID> locPB : cmp) {
-            if (locPB == locPA) continue;
-
-            NodeID q = locPB.second;
-
-            switch (alias(p, q)) {
-            case llvm::NoAlias:
-                ++(*noAliases);
-                break;
-            case llvm::MayAlias:
-                ++(*mayAliases);
-                break;
-            default:
-                assert("Not May/NoAlias?");
+/*!
+ * Sort groups by their sets and merge the groups with the same set.
+ */
+static void mergeSameSetGroups(std::vector<std::pair<std::vector<NodeID>, u64_t>> &groups) {
+    std::sort(groups.begin(), groups.end());
+    u32_t numOfMerged = 0;
+    for (u32_t i = 0; i < groups.size(); ++i) {
+        if (numOfMerged > 0 && groups[numOfMerged - 1].first == groups[i].first) {
+            groups[numOfMerged - 1].second += groups[i].second;
+        } else {
+            groups[numOfMerged++].swap(groups[i]);
+        }
+    }
+
+    groups.resize(numOfMerged);
+}
+
+/*!
+ * Count the results of alias(a, b) over all ordered pairs of distinct
+ * entries, where ptsList[i] is the points-to set of weights[i] entries,
+ * without testing every pair. Entries with the same points-to set are
+ * grouped before their sets are expanded (as alias does), and again after.
+ * The groups a group intersects are then found through an object -> groups
+ * index, and a group holding an object of every group intersects them all.
+ * The cost depends on the distinct sets and how much they overlap, not on
+ * the number of entries.
+ */
+void FlowSensitive::countAliases(const std::vector<const PointsTo *> &ptsList, const std::vector<u64_t> &weights,
+                                 unsigned *mayAliases, unsigned *noAliases) {
+    typedef std::vector<NodeID> ObjVector;
+    typedef std::vector<std::pair<ObjVector, u64_t>> Groups;
+
+    Groups rawGroups(ptsList.size());
+    for (u32_t i = 0; i < ptsList.size(); ++i) {
+        rawGroups[i].first.assign(ptsList[i]->begin(), ptsList[i]->end());
+        rawGroups[i].second = weights[i];
+    }
+
+    mergeSameSetGroups(rawGroups);
+
+    // Expand once per distinct set.
+    Groups groups(rawGroups.size());
+    for (u32_t g = 0; g < rawGroups.size(); ++g) {
+        PointsTo pts, expanded;
+        for (NodeID o : rawGroups[g].first) {
+            pts.set(o);
+        }
+
+        expandFIObjs(pts, expanded);
+        groups[g].first.assign(expanded.begin(), expanded.end());
+        groups[g].second = rawGroups[g].second;
+    }
+
+    rawGroups.clear();
+    mergeSameSetGroups(groups);
+
+    // Groups with the black hole may alias everything; others are indexed by object.
+    NodeID blackHole = pag->getBlackHoleNode();
+    u32_t numOfGroups = groups.size();
+    std::vector<char> hasBlackHole(numOfGroups, false);
+    u64_t numOfEntries = 0, numInBlackHoleGroups = 0, numInIndexedGroups = 0;
+    u32_t numOfIndexedGroups = 0;
+    DenseMap<NodeID, std::vector<u32_t>> objToGroups;
+    for (u32_t g = 0; g < numOfGroups; ++g) {
+        const ObjVector &objs = groups[g].first;
+        numOfEntries += groups[g].second;
+        if (std::binary_search(objs.begin(), objs.end(), blackHole)) {
+            hasBlackHole[g] = true;
+            numInBlackHoleGroups += groups[g].second;
+            continue;
+        }
+
+        if (objs.empty()) {
+            continue;
+        }
+
+        ++numOfIndexedGroups;
+        numInIndexedGroups += groups[g].second;
+        for (NodeID o : objs) {
+            objToGroups[o].push_back(g);
+        }
+    }
+
+    // Number of entries each entry of a group may alias.
+    std::vector<u64_t> mayPartners(numOfGroups, 0);
+    parallelFor(0, numOfGroups, [&](u32_t g) {
+        const ObjVector &objs = groups[g].first;
+        if (hasBlackHole[g]) {
+            mayPartners[g] = numOfEntries - 1;
+            return;
+        }
+
+        if (objs.empty()) {
+            // Only the black hole groups; never this group itself.
+            mayPartners[g] = numInBlackHoleGroups;
+            return;
+        }
+
+        std::vector<u32_t> others;
+        for (NodeID o : objs) {
+            const std::vector<u32_t> &oGroups = objToGroups.find(o)->second;
+            if (oGroups.size() == numOfIndexedGroups) {
+                // o is in every indexed group.
+                mayPartners[g] = numInIndexedGroups + numInBlackHoleGroups - 1;
+                return;
             }
+
+            others.insert(others.end(), oGroups.begin(), oGroups.end());
+        }
+
+        std::sort(others.begin(), others.end());
+        others.erase(std::unique(others.begin(), others.end()), others.end());
+
+        u64_t partners = numInBlackHoleGroups;
+        for (u32_t h : others) {
+            partners += groups[h].second;
+        }
+
+        // g itself is among others; an entry is not paired with itself.
+        mayPartners[g] = partners - 1;
+    });
+
+    u64_t numOfMay = 0;
+    for (u32_t g = 0; g < numOfGroups; ++g) {
+        numOfMay += groups[g].second * mayPartners[g];
+    }
+
+    u64_t numOfPairs = numOfEntries == 0 ? 0 : numOfEntries * (numOfEntries - 1);
+    *mayAliases += numOfMay;
+    *noAliases += numOfPairs - numOfMay;
+
+    if (CheckCTirAliasEval)
+        validateAliasCountTests(ptsList, weights, numOfMay, numOfPairs - numOfMay);
+}
+
+/*!
+ * Check the grouped alias counts against the alias result of every ordered
+ * pair of distinct entries (-ctir-check-alias-eval).
+ * Each set is expanded once as alias expands it; the pairs are compared
+ * one by one, so this is quadratic in the number of sets.
+ */
+void FlowSensitive::validateAliasCountTests(const std::vector<const PointsTo *> &ptsList, const std::vector<u64_t> &weights,
+        u64_t numOfMay, u64_t numOfNo) {
+    outs() << "[" << PTAName() << "] Checking the alias counts of " << ptsList.size() << " points-to sets\n";
+
+    u32_t numOfSets = ptsList.size();
+    std::vector<PointsTo> expanded(numOfSets);
+    std::vector<char> hasBlackHole(numOfSets, false);
+    for (u32_t i = 0; i < numOfSets; ++i) {
+        bool blackHole = false;
+        expandForAlias(*ptsList[i], expanded[i], blackHole);
+        hasBlackHole[i] = blackHole;
+    }
+
+    u64_t refMay = 0, refNo = 0;
+    for (u32_t i = 0; i < numOfSets; ++i) {
+        for (u32_t j = 0; j < numOfSets; ++j) {
+            // Entries of the same set are paired with each other but not with themselves.
+            u64_t numOfPairs = i == j ? weights[i] * (weights[i] - (weights[i] == 0 ? 0 : 1)) : weights[i] * weights[j];
+            if (aliasOfExpanded(expanded[i], hasBlackHole[i], expanded[j], hasBlackHole[j]) == llvm::MayAlias)
+                refMay += numOfPairs;
+            else
+                refNo += numOfPairs;
         }
     }
 
+    if (refMay == numOfMay && refNo == numOfNo)
+        outs() << sucMsg("\t SUCCESS :") << numOfMay << " may and " << numOfNo << " no aliases, as alias gives pair by pair\n";
+    else
+        SVFUtil::errs() << errMsg("\t FAIL :") << "counted " << numOfMay << " may and " << numOfNo
+                        << " no aliases, alias gives " << refMay << " and " << refNo << " pair by pair\n";
 }
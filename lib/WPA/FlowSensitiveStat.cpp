@@ -219,6 +219,11 @@ void FlowSensitiveStat::performStat()
     PTNumStatMap["MaxINPtsSize"] = _MaxInOutPtsSize[IN];
     PTNumStatMap["MaxOUTPtsSize"] = _MaxInOutPtsSize[OUT];
 
+    if (SVFUtil::isa<BVDataPTAImpl::HCDFPTDataTy>(fspta->getDFPTDataTy())) {
+        PTNumStatMap["HCPtsSets"] = PointsTo::numHashConsedSets();
+        PTNumStatMap["HCUnionHits"] = PointsTo::numHashConsedUnionHits();
+    }
+
     timeStatMap["AvgPtsSize"] = _AvgPtsSize;
     timeStatMap["AvgTopLvlPtsSize"] = _AvgTopLvlPtsSize;
 
@@ -296,9 +301,9 @@ void FlowSensitiveStat::statNullPtr()
 void FlowSensitiveStat::statPtsSize()
 {
     // stat of IN set
-    statInOutPtsSize(fspta->getDFInputMap(), IN);
+    statInOutPtsSize(IN);
     // stat of OUT set
-    statInOutPtsSize(fspta->getDFOutputMap(), OUT);
+    statInOutPtsSize(OUT);
 
     /// get points-to set size information for top-level pointers.
     u32_t totalValidTopLvlPointers = 0;
@@ -327,16 +332,22 @@ void FlowSensitiveStat::statPtsSize()
         _AvgPtsSize = (double) _TotalPtsSize / totalPointer;
 }
 
-void FlowSensitiveStat::statInOutPtsSize(const DFInOutMap& data, ENUM_INOUT inOrOut)
+void FlowSensitiveStat::statInOutPtsSize(ENUM_INOUT inOrOut)
 {
+    BVDataPTAImpl::DFPTDataTy* dfPTData = fspta->getDFPTDataTy();
+    NodeBS locs;
+    if (inOrOut == IN)
+        dfPTData->getDFInLocs(locs);
+    else
+        dfPTData->getDFOutLocs(locs);
+
     // Get number of nodes which have IN/OUT set
-    _NumOfSVFGNodesHaveInOut[inOrOut] = data.size();
+    _NumOfSVFGNodesHaveInOut[inOrOut] = locs.count();
 
     u32_t inOutPtsSize = 0;
-    DFInOutMap::const_iterator it = data.begin();
-    DFInOutMap::const_iterator eit = data.end();
-    for (; it != eit; ++it) {
-        const SVFGNode* node = fspta->svfg->getSVFGNode(it->first);
+    for (NodeBS::iterator it = locs.begin(), eit = locs.end(); it != eit; ++it) {
+        const NodeID loc = *it;
+        const SVFGNode* node = fspta->svfg->getSVFGNode(loc);
 
         // Count number of SVFG nodes have IN/OUT set.
         if (SVFUtil::isa<FormalINSVFGNode>(node))
@@ -359,13 +370,17 @@ void FlowSensitiveStat::statInOutPtsSize(const DFInOutMap& data, ENUM_INOUT inOr
         /*-----------------------------------------------------*/
 
         // Count PAG nodes and their points-to set size.
-        const PtsMap& cptsMap = it->second;
-        PtsMap::const_iterator ptsIt = cptsMap.begin();
-        PtsMap::const_iterator ptsEit = cptsMap.end();
-        for (; ptsIt != ptsEit; ++ptsIt) {
-            if (ptsIt->second.empty()) continue;
+        NodeBS vars;
+        if (inOrOut == IN)
+            dfPTData->getDFInVars(loc, vars);
+        else
+            dfPTData->getDFOutVars(loc, vars);
+        for (NodeBS::iterator ptsIt = vars.begin(), ptsEit = vars.end(); ptsIt != ptsEit; ++ptsIt) {
+            const PointsTo& pts = inOrOut == IN ? dfPTData->getDFInPtsSet(loc, *ptsIt)
+                                  : dfPTData->getDFOutPtsSet(loc, *ptsIt);
+            if (pts.empty()) continue;
 
-            u32_t ptsNum = ptsIt->second.count();	/// points-to target number
+            u32_t ptsNum = pts.count();	/// points-to target number
 
             // Only node with non-empty points-to set are counted.
             _NumOfVarHaveINOUTPts[inOrOut]++;
@@ -16,6 +16,9 @@
 /// Whether we allow reuse for TBHC.
 static llvm::cl::opt<bool> TBHCStoreReuse("tbhc-store-reuse", llvm::cl::init(false), llvm::cl::desc("Allow for object reuse in at stores in FSTBHC"));
 static llvm::cl::opt<bool> TBHCAllReuse("tbhc-all-reuse", llvm::cl::init(false), llvm::cl::desc("Allow for object reuse everywhere in FSTBHC"));
+static llvm::cl::opt<bool> TBHCCheckCaches("tbhc-check-caches", llvm::cl::init(false), llvm::cl::desc("Check the TBHC lookup caches, and the memoised type relations and interned types of the DCHG, against what they replace after solving"));
+static llvm::cl::opt<bool> TBHCCheckSlice("tbhc-check-slice", llvm::cl::init(false), llvm::cl::desc("Check the slice solved by -tbhc-demand holds every SVFG node the queries depend on after solving"));
+static llvm::cl::opt<bool> TBHCDemand("tbhc-demand", llvm::cl::init(false), llvm::cl::desc("Only solve the part of the SVFG the queries (by default, ctir loads/stores/GEPs) depend on in FSTBHC"));
 
 FlowSensitiveTBHC::FlowSensitiveTBHC(PTATY type) : FlowSensitive(type), TypeBasedHeapCloning(this) {
     // Using `this` as the argument for TypeBasedHeapCloning is okay. As PointerAnalysis, it's
@@ -23,6 +26,7 @@ FlowSensitiveTBHC::FlowSensitiveTBHC(PTATY type) : FlowSensitive(type), TypeBase
     // just needs to be allocated, which it is.
     allReuse = TBHCAllReuse;
     storeReuse = allReuse || TBHCStoreReuse;
+    demandDriven = TBHCDemand;
 }
 
 void FlowSensitiveTBHC::analyze(SVFModule svfModule) {
@@ -53,6 +57,20 @@ void FlowSensitiveTBHC::finalize(void) {
     dumpStats();
     // getDFPTDataTy()->dumpPTData();
 
+    if (demandDriven) {
+        SVFUtil::outs() << "FSTBHC demand-driven: solved " << slice.count()
+                        << " of " << svfg->getTotalNodeNum() << " SVFG nodes\n";
+        if (TBHCCheckSlice) {
+            validateSliceTests();
+        }
+    }
+
+    if (TBHCCheckCaches) {
+        validateLookupCacheTests();
+        dchg->validateRelationTests();
+        dchg->validateCanonicalTypeTests();
+    }
+
     validateTBHCTests(svfMod);
 }
 
@@ -76,6 +94,98 @@ void FlowSensitiveTBHC::backPropagate(NodeID clone) {
     }
 }
 
+void FlowSensitiveTBHC::solve(void) {
+    // The call graph may have been updated, connecting more nodes.
+    if (demandDriven) computeSlice();
+    FlowSensitive::solve();
+}
+
+void FlowSensitiveTBHC::pushIntoWorklist(NodeID id) {
+    if (demandDriven && !slice.test(id)) return;
+    FlowSensitive::pushIntoWorklist(id);
+}
+
+void FlowSensitiveTBHC::computeSlice(void) {
+    if (queryLocs.empty() && queryPtrs.empty()) {
+        std::set<std::pair<NodeID, NodeID>> cmpLocs;
+        collectCTirAliasLocs(cmpLocs);
+        for (const std::pair<NodeID, NodeID> &locP : cmpLocs) {
+            queryLocs.set(locP.first);
+        }
+    }
+
+    NodeBS roots = queryLocs;
+    for (NodeID ptr : queryPtrs) {
+        const PAGNode *ptrNode = pag->getPAGNode(ptr);
+        if (svfg->hasDefSVFGNode(ptrNode)) {
+            roots.set(svfg->getDefSVFGNode(ptrNode)->getId());
+        }
+    }
+
+    const CallSiteToFunPtrMap &indCallsites = pag->getIndirectCallsites();
+    for (CallSiteToFunPtrMap::const_iterator csI = indCallsites.begin(); csI != indCallsites.end(); ++csI) {
+        const PAGNode *funPtrNode = pag->getPAGNode(csI->second);
+        if (svfg->hasDefSVFGNode(funPtrNode)) {
+            roots.set(svfg->getDefSVFGNode(funPtrNode)->getId());
+        }
+    }
+
+    // Backward traversal, like DDAVFSolver's, but along all value-flow edges.
+    slice.clear();
+    FIFOWorkList<NodeID> worklist;
+    for (NodeID root : roots) {
+        slice.set(root);
+        worklist.push(root);
+    }
+
+    while (!worklist.empty()) {
+        const SVFGNode *node = svfg->getSVFGNode(worklist.pop());
+        for (const SVFGEdge *edge : node->getInEdges()) {
+            NodeID src = edge->getSrcID();
+            if (!slice.test(src)) {
+                slice.set(src);
+                worklist.push(src);
+            }
+        }
+    }
+}
+
+void FlowSensitiveTBHC::validateSliceTests(void) {
+    SVFUtil::outs() << "[" << PTAName() << "] Checking the demand-driven slice\n";
+
+    unsigned numFailures = 0;
+    auto check = [&](bool ok, const char *what, NodeID id) {
+        if (!ok && numFailures++ < 10) {
+            SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << what << " " << id << " is not in the slice\n";
+        }
+    };
+
+    // Call graph updates after the last computeSlice would leave new in-edges out.
+    for (NodeID id : slice) {
+        for (const SVFGEdge *edge : svfg->getSVFGNode(id)->getInEdges()) {
+            check(slice.test(edge->getSrcID()), "source of an in-edge of slice node", edge->getSrcID());
+        }
+    }
+
+    for (NodeID loc : queryLocs) {
+        check(slice.test(loc), "queried SVFG node", loc);
+    }
+
+    for (NodeID ptr : queryPtrs) {
+        const PAGNode *ptrNode = pag->getPAGNode(ptr);
+        if (svfg->hasDefSVFGNode(ptrNode)) {
+            check(slice.test(svfg->getDefSVFGNode(ptrNode)->getId()), "definition of queried pointer", ptr);
+        }
+    }
+
+    if (numFailures == 0) {
+        SVFUtil::outs() << SVFUtil::sucMsg("\t SUCCESS :") << "the slice of " << slice.count()
+                        << " SVFG nodes holds everything the queries depend on\n";
+    } else {
+        SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << numFailures << " SVFG nodes the queries depend on were not solved\n";
+    }
+}
+
 bool FlowSensitiveTBHC::propAlongIndirectEdge(const IndirectSVFGEdge* edge) {
     SVFGNode* src = edge->getSrcNode();
     SVFGNode* dst = edge->getDstNode();
@@ -554,11 +664,13 @@ void FlowSensitiveTBHC::expandFIObjs(const PointsTo& pts, PointsTo& expandedPts)
 }
 
 void FlowSensitiveTBHC::countAliases(std::set<std::pair<NodeID, NodeID>> cmp, unsigned *mayAliases, unsigned *noAliases) {
-    std::map<std::pair<NodeID, NodeID>, PointsTo> filteredPts;
+    std::vector<PointsTo> filteredPts;
+    filteredPts.reserve(cmp.size());
     for (std::pair<NodeID, NodeID> locP : cmp) {
         const PointsTo &filterSet = getFilterSet(locP.first);
         const PointsTo &pts = getPts(locP.second);
-        PointsTo &ptsFiltered = filteredPts[locP];
+        filteredPts.push_back(PointsTo());
+        PointsTo &ptsFiltered = filteredPts.back();
 
         for (NodeID o : pts) {
             if (filterSet.test(o)) continue;
@@ -566,26 +678,11 @@ void FlowSensitiveTBHC::countAliases(std::set<std::pair<NodeID, NodeID>> cmp, un
         }
     }
 
-    for (std::pair<NodeID, NodeID> locPA : cmp) {
-        NodeID locA = locPA.first;
-        NodeID a = locPA.second;
-
-        const PointsTo &aPts = filteredPts[locPA];
-        for (std::pair<NodeID, NodeID> locPB : cmp) {
-            if (locPB == locPA) continue;
-            const PointsTo &bPts = filteredPts[locPB];
-
-            switch (alias(aPts, bPts)) {
-            case llvm::NoAlias:
-                ++(*noAliases);
-                break;
-            case llvm::MayAlias:
-                ++(*mayAliases);
-                break;
-            default:
-                assert("Not May/NoAlias?");
-            }
-        }
+    // Locations with the same filtered set are grouped by countAliases.
+    std::vector<const PointsTo *> ptsList;
+    for (const PointsTo &pts : filteredPts) {
+        ptsList.push_back(&pts);
     }
 
+    FlowSensitive::countAliases(ptsList, std::vector<u64_t>(ptsList.size(), 1), mayAliases, noAliases);
 }
@@ -42,6 +42,7 @@
 #include "WPA/FlowSensitiveContextSensitive.h"
 #include "WPA/FlowSensitiveTBHC.h"
 #include "WPA/TypeAnalysis.h"
+#include "Util/Parallel.h"
 
 char WPAPass::ID = 0;
 
@@ -62,6 +63,7 @@ static llvm::cl::bits<PointerAnalysis::PTATY> PASelected(llvm::cl::desc("Select
             clEnumValN(PointerAnalysis::AndersenWaveDiff_WPA, "wander", "Wave propagation inclusion-based analysis"),
             clEnumValN(PointerAnalysis::AndersenWaveDiff_WPA, "ander", "Diff wave propagation inclusion-based analysis"),
             clEnumValN(PointerAnalysis::AndersenWaveDiffWithType_WPA, "andertype", "Diff wave propagation with type inclusion-based analysis"),
+            clEnumValN(PointerAnalysis::AndersenWaveDiffParallel_WPA, "pwander", "Parallel diff wave propagation inclusion-based analysis"),
             clEnumValN(PointerAnalysis::FSSPARSE_WPA, "fspta", "Sparse flow sensitive pointer analysis"),
             clEnumValN(PointerAnalysis::FSTBHC_WPA, "fstbhc", "Flow-sensitive type-based heap cloning"),
             clEnumValN(PointerAnalysis::FSCS_WPA, "fscs", "Flow-sensitive context-sensitive pointer analysis"),
@@ -81,6 +83,21 @@ static llvm::cl::opt<bool> anderSVFG("svfg", llvm::cl::init(false),
 static llvm::cl::opt<bool> printAliases("print-aliases", llvm::cl::init(false),
                         llvm::cl::desc("Print results for all pair aliases"));
 
+static llvm::cl::opt<unsigned> aliasCacheSize("alias-cache-size", llvm::cl::init(1 << 16),
+                        llvm::cl::desc("Number of alias results cached by WPAPass (0 disables the cache)"));
+
+static llvm::cl::opt<bool> checkAliasBatch("check-alias-batch", llvm::cl::init(false),
+                        llvm::cl::desc("Check batched and cached alias results against answering the pairs one by one"));
+
+static llvm::cl::opt<PointsTo::Type> ptsRep("ptsrep", llvm::cl::init(PointsTo::SBV),
+        llvm::cl::desc("Select points-to set representation"),
+        llvm::cl::values(
+            clEnumValN(PointsTo::SBV, "sbv", "Sparse bit vector"),
+            clEnumValN(PointsTo::BV, "bv", "Dense bit vector"),
+            clEnumValN(PointsTo::SV, "sv", "Sorted small vector (for small sets)"),
+            clEnumValN(PointsTo::HCS, "hcs", "Hash-consed sparse bit vector")
+        ));
+
 
 /*!
  * Destructor
@@ -99,6 +116,9 @@ WPAPass::~WPAPass() {
  * We start from here
  */
 void WPAPass::runOnModule(SVFModule svfModule) {
+    PointsTo::setDefaultType(ptsRep);
+    aliasCacheList.clear();
+    aliasCacheMap.clear();
     for (u32_t i = 0; i<= PointerAnalysis::Default_PTA; i++) {
         if (PASelected.isSet(i))
             runPointerAnalysis(svfModule, i);
@@ -138,6 +158,9 @@ void WPAPass::runPointerAnalysis(SVFModule svfModule, u32_t kind)
         case PointerAnalysis::AndersenWaveDiffWithType_WPA:
             _pta = new AndersenWaveDiffWithType();
             break;
+        case PointerAnalysis::AndersenWaveDiffParallel_WPA:
+            _pta = new AndersenWaveDiffParallel();
+            break;
         case PointerAnalysis::FSSPARSE_WPA:
             _pta = new FlowSensitive();
             break;
@@ -168,8 +191,31 @@ void WPAPass::runPointerAnalysis(SVFModule svfModule, u32_t kind)
 		PrintAliasPairs(_pta);
 }
 
+/*!
+ * Print the alias result of every pair of PAG nodes. Pairs are answered in
+ * batches so that points-to sets are expanded once per batch, not per pair.
+ */
 void WPAPass::PrintAliasPairs(PointerAnalysis* pta) {
 	PAG* pag = pta->getPAG();
+	const u32_t batchSize = 1 << 16;
+	NodePairVector pairs;
+	AliasResultVector results;
+	auto printPairs = [&]() {
+		computeAliases(pta, pairs, results);
+		for (u32_t i = 0; i < pairs.size(); ++i) {
+			PAGNode* node1 = pag->getPAGNode(pairs[i].first);
+			PAGNode* node2 = pag->getPAGNode(pairs[i].second);
+			const Function* fun1 = node1->getFunction();
+			const Function* fun2 = node2->getFunction();
+			SVFUtil::outs()	<< (results[i] == AliasResult::NoAlias ? "NoAlias" : "MayAlias")
+					<< " var" << node1->getId() << "[" << node1->getValueName()
+					<< "@" << (fun1==NULL?"":fun1->getName()) << "] --"
+					<< " var" << node2->getId() << "[" << node2->getValueName()
+					<< "@" << (fun2==NULL?"":fun2->getName()) << "]\n";
+		}
+		pairs.clear();
+	};
+
 	for (PAG::iterator lit = pag->begin(), elit = pag->end(); lit != elit; ++lit) {
 		PAGNode* node1 = lit->second;
 		PAGNode* node2 = node1;
@@ -177,16 +223,15 @@ void WPAPass::PrintAliasPairs(PointerAnalysis* pta) {
 			node2 = rit->second;
 			if(node1==node2)
 				continue;
-			const Function* fun1 = node1->getFunction();
-			const Function* fun2 = node2->getFunction();
-			AliasResult result = pta->alias(node1->getId(), node2->getId());
-			SVFUtil::outs()	<< (result == AliasResult::NoAlias ? "NoAlias" : "MayAlias")
-					<< " var" << node1->getId() << "[" << node1->getValueName()
-					<< "@" << (fun1==NULL?"":fun1->getName()) << "] --"
-					<< " var" << node2->getId() << "[" << node2->getValueName()
-					<< "@" << (fun2==NULL?"":fun2->getName()) << "]\n";
+			pairs.push_back(std::make_pair(node1->getId(), node2->getId()));
+			if (pairs.size() == batchSize)
+				printPairs();
 		}
 	}
+	if (!pairs.empty())
+		printPairs();
+	if (checkAliasBatch)
+		reportAliasTests("the alias pairs printed");
 }
 
 /*!
@@ -194,39 +239,272 @@ void WPAPass::PrintAliasPairs(PointerAnalysis* pta) {
  * TODO: Need to handle PartialAlias and MustAlias here.
  */
 AliasResult WPAPass::alias(const Value* V1, const Value* V2) {
+    PAG* pag = _pta->getPAG();
 
+    /// As in the batch version, Values without PAG nodes may alias anything.
+    if (!pag->hasValueNode(V1) || !pag->hasValueNode(V2))
+        return llvm::MayAlias;
+
+    NodeID n1 = pag->getValueNode(V1);
+    NodeID n2 = pag->getValueNode(V2);
+    NodePair pair = n1 < n2 ? std::make_pair(n1, n2) : std::make_pair(n2, n1);
     AliasResult result = llvm::MayAlias;
+    if (getCachedAlias(pair, result))
+        return result;
+
+    result = computeAlias(pair);
+    addCachedAlias(pair, result);
+    return result;
+}
+
+/*!
+ * Return alias results of a batch of queries. Each distinct node pair not in
+ * the cache is computed once, however often it is queried.
+ *
+ * TODO: When this method is invoked during compiler optimizations, the IR
+ *       used for pointer analysis may been changed, so some Values may not
+ *       find corresponding PAG node. In this case, we only check alias
+ *       between two Values if they both have PAG nodes. Otherwise, MayAlias
+ *       will be returned.
+ */
+void WPAPass::alias(const ValuePairVector& queries, AliasResultVector& results) {
+    results.assign(queries.size(), llvm::MayAlias);
 
     PAG* pag = _pta->getPAG();
+    NodePairVector misses;
+    DenseMap<NodePair, u32_t> missToIndex;
+    std::vector<std::pair<u32_t, u32_t> > pending;	///< (query, miss) pairs
+    for (u32_t i = 0; i < queries.size(); ++i) {
+        const Value* V1 = queries[i].first;
+        const Value* V2 = queries[i].second;
+        if (!pag->hasValueNode(V1) || !pag->hasValueNode(V2))
+            continue;
+
+        NodeID n1 = pag->getValueNode(V1);
+        NodeID n2 = pag->getValueNode(V2);
+        NodePair pair = n1 < n2 ? std::make_pair(n1, n2) : std::make_pair(n2, n1);
+        if (getCachedAlias(pair, results[i]))
+            continue;
+
+        DenseMap<NodePair, u32_t>::iterator it = missToIndex.find(pair);
+        if (it == missToIndex.end()) {
+            it = missToIndex.insert(std::make_pair(pair, misses.size())).first;
+            misses.push_back(pair);
+        }
+        pending.push_back(std::make_pair(i, it->second));
+    }
+
+    if (!misses.empty()) {
+        AliasResultVector missResults;
+        computeAliases(misses, missResults);
+        for (u32_t m = 0; m < misses.size(); ++m)
+            addCachedAlias(misses[m], missResults[m]);
+        for (u32_t p = 0; p < pending.size(); ++p)
+            results[pending[p].first] = missResults[pending[p].second];
+    }
+
+    if (checkAliasBatch) {
+        /// Compare the answer of each query, cached or not, with the rule applied to the pair alone
+        NodePairVector pairs;
+        AliasResultVector pairResults;
+        for (u32_t i = 0; i < queries.size(); ++i) {
+            const Value* V1 = queries[i].first;
+            const Value* V2 = queries[i].second;
+            if (!pag->hasValueNode(V1) || !pag->hasValueNode(V2))
+                continue;
+            pairs.push_back(std::make_pair(pag->getValueNode(V1), pag->getValueNode(V2)));
+            pairResults.push_back(results[i]);
+        }
+        validateAliasTests(NULL, pairs, pairResults);
+        reportAliasTests("a batch of " + std::to_string(queries.size()) + " queries");
+    }
+}
+
+/*!
+ * Alias result of one node pair, combined over all pointer analyses by the
+ * alias check rule, without the set-up of the batch version
+ */
+AliasResult WPAPass::computeAlias(const NodePair& pair) {
+    /// Veto is used by default
+    if (AliasRule.getBits() == 0 || AliasRule.isSet(Veto)) {
+        /// Return NoAlias if any PTA gives NoAlias result
+        for (PTAVector::const_iterator it = ptaVector.begin(), eit = ptaVector.end();
+                it != eit; ++it) {
+            if ((*it)->alias(pair.first, pair.second) == llvm::NoAlias)
+                return llvm::NoAlias;
+        }
+        return llvm::MayAlias;
+    }
+    else if (AliasRule.isSet(Conservative)) {
+        /// Return MayAlias if any PTA gives MayAlias result
+        for (PTAVector::const_iterator it = ptaVector.begin(), eit = ptaVector.end();
+                it != eit; ++it) {
+            if ((*it)->alias(pair.first, pair.second) == llvm::MayAlias)
+                return llvm::MayAlias;
+        }
+        return llvm::NoAlias;
+    }
+    return llvm::MayAlias;
+}
 
-    /// TODO: When this method is invoked during compiler optimizations, the IR
-    ///       used for pointer analysis may been changed, so some Values may not
-    ///       find corresponding PAG node. In this case, we only check alias
-    ///       between two Values if they both have PAG nodes. Otherwise, MayAlias
-    ///       will be returned.
-    if (pag->hasValueNode(V1) && pag->hasValueNode(V2)) {
-        /// Veto is used by default
-        if (AliasRule.getBits() == 0 || AliasRule.isSet(Veto)) {
-            /// Return NoAlias if any PTA gives NoAlias result
-            result = llvm::MayAlias;
-
-            for (PTAVector::const_iterator it = ptaVector.begin(), eit = ptaVector.end();
-                    it != eit; ++it) {
-                if ((*it)->alias(V1, V2) == llvm::NoAlias)
-                    result = llvm::NoAlias;
+/*!
+ * Combine the results of all pointer analyses by the alias check rule
+ */
+void WPAPass::computeAliases(const NodePairVector& pairs, AliasResultVector& results) {
+    AliasResultVector ptaResults;
+    /// Veto is used by default
+    if (AliasRule.getBits() == 0 || AliasRule.isSet(Veto)) {
+        /// Return NoAlias if any PTA gives NoAlias result
+        results.assign(pairs.size(), llvm::MayAlias);
+
+        for (PTAVector::const_iterator it = ptaVector.begin(), eit = ptaVector.end();
+                it != eit; ++it) {
+            computeAliases(*it, pairs, ptaResults);
+            for (u32_t i = 0; i < pairs.size(); ++i) {
+                if (ptaResults[i] == llvm::NoAlias)
+                    results[i] = llvm::NoAlias;
             }
         }
-        else if (AliasRule.isSet(Conservative)) {
-            /// Return MayAlias if any PTA gives MayAlias result
-            result = llvm::NoAlias;
-
-            for (PTAVector::const_iterator it = ptaVector.begin(), eit = ptaVector.end();
-                    it != eit; ++it) {
-                if ((*it)->alias(V1, V2) == llvm::MayAlias)
-                    result = llvm::MayAlias;
+    }
+    else if (AliasRule.isSet(Conservative)) {
+        /// Return MayAlias if any PTA gives MayAlias result
+        results.assign(pairs.size(), llvm::NoAlias);
+
+        for (PTAVector::const_iterator it = ptaVector.begin(), eit = ptaVector.end();
+                it != eit; ++it) {
+            computeAliases(*it, pairs, ptaResults);
+            for (u32_t i = 0; i < pairs.size(); ++i) {
+                if (ptaResults[i] == llvm::MayAlias)
+                    results[i] = llvm::MayAlias;
             }
         }
     }
+    else {
+        results.assign(pairs.size(), llvm::MayAlias);
+    }
+}
 
-    return result;
+/*!
+ * Alias results of node pairs given by pta.
+ *
+ * For BVDataPTAImpl, nodes of an SCC share one points-to set, so the pairs
+ * are deduplicated by the identity of their points-to sets. Each distinct
+ * set is expanded once, sequentially since expanding may look up the PAG,
+ * and the distinct set pairs are then compared in parallel with the same
+ * helpers as BVDataPTAImpl::alias.
+ */
+void WPAPass::computeAliases(PointerAnalysis* pta, const NodePairVector& pairs, AliasResultVector& results) {
+    results.assign(pairs.size(), llvm::MayAlias);
+
+    BVDataPTAImpl* bvPta = SVFUtil::dyn_cast<BVDataPTAImpl>(pta);
+    if (bvPta == NULL) {
+        for (u32_t i = 0; i < pairs.size(); ++i)
+            results[i] = pta->alias(pairs[i].first, pairs[i].second);
+        return;
+    }
+
+    DenseMap<const PointsTo*, u32_t> ptsToIndex;
+    std::vector<PointsTo> expandedPts;
+    std::vector<char> hasBlackHole;
+    auto getPtsIndex = [&](NodeID id) {
+        // Nodes without a points-to set share the index of NULL, an empty set.
+        const PointsTo* pts = bvPta->findPts(id);
+        DenseMap<const PointsTo*, u32_t>::iterator it = ptsToIndex.find(pts);
+        if (it != ptsToIndex.end())
+            return it->second;
+        u32_t index = expandedPts.size();
+        ptsToIndex[pts] = index;
+        expandedPts.push_back(PointsTo());
+        bool blackHole = false;
+        if (pts != NULL)
+            bvPta->expandForAlias(*pts, expandedPts.back(), blackHole);
+        hasBlackHole.push_back(blackHole);
+        return index;
+    };
+
+    NodePairVector ptsPairs;
+    DenseMap<NodePair, u32_t> ptsPairToIndex;
+    std::vector<u32_t> pairToPtsPair(pairs.size());
+    for (u32_t i = 0; i < pairs.size(); ++i) {
+        u32_t p1 = getPtsIndex(pairs[i].first);
+        u32_t p2 = getPtsIndex(pairs[i].second);
+        NodePair ptsPair = p1 < p2 ? std::make_pair(p1, p2) : std::make_pair(p2, p1);
+        DenseMap<NodePair, u32_t>::iterator it = ptsPairToIndex.find(ptsPair);
+        if (it == ptsPairToIndex.end()) {
+            it = ptsPairToIndex.insert(std::make_pair(ptsPair, ptsPairs.size())).first;
+            ptsPairs.push_back(ptsPair);
+        }
+        pairToPtsPair[i] = it->second;
+    }
+
+    AliasResultVector ptsPairResults(ptsPairs.size(), llvm::MayAlias);
+    SVFUtil::parallelFor(0, ptsPairs.size(), [&](u32_t i) {
+        u32_t p1 = ptsPairs[i].first;
+        u32_t p2 = ptsPairs[i].second;
+        ptsPairResults[i] = BVDataPTAImpl::aliasOfExpanded(expandedPts[p1], hasBlackHole[p1],
+                            expandedPts[p2], hasBlackHole[p2]);
+    }, SVFUtil::getNumOfPtsWorkers());
+
+    for (u32_t i = 0; i < pairs.size(); ++i)
+        results[i] = ptsPairResults[pairToPtsPair[i]];
+
+    if (checkAliasBatch)
+        validateAliasTests(pta, pairs, results);
+}
+
+/*!
+ * Look a node pair up in the alias cache, making it the most recently used
+ */
+bool WPAPass::getCachedAlias(const NodePair& pair, AliasResult& result) {
+    AliasCacheMap::iterator it = aliasCacheMap.find(pair);
+    if (it == aliasCacheMap.end())
+        return false;
+    aliasCacheList.splice(aliasCacheList.begin(), aliasCacheList, it->second);
+    result = it->second->second;
+    return true;
+}
+
+/*!
+ * Cache the alias result of a node pair, evicting the least recently used
+ * result if the cache is full
+ */
+void WPAPass::addCachedAlias(const NodePair& pair, AliasResult result) {
+    if (aliasCacheSize == 0 || aliasCacheMap.count(pair))
+        return;
+    if (aliasCacheMap.size() >= aliasCacheSize) {
+        aliasCacheMap.erase(aliasCacheList.back().first);
+        aliasCacheList.pop_back();
+    }
+    aliasCacheList.push_front(std::make_pair(pair, result));
+    aliasCacheMap[pair] = aliasCacheList.begin();
+}
+
+/*!
+ * Compare batched alias results with answering each pair alone: with
+ * pta->alias if pta is given, otherwise with computeAlias, which applies
+ * the alias check rule over all pointer analyses.
+ */
+void WPAPass::validateAliasTests(PointerAnalysis* pta, const NodePairVector& pairs, const AliasResultVector& results) {
+    for (u32_t i = 0; i < pairs.size(); ++i) {
+        AliasResult expected = pta ? pta->alias(pairs[i].first, pairs[i].second) : computeAlias(pairs[i]);
+        ++numOfCheckedAliases;
+        if (results[i] != expected && numOfAliasMismatches++ < 10)
+            SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << "var" << pairs[i].first << " -- var" << pairs[i].second
+                            << (results[i] == llvm::NoAlias ? " NoAlias" : " MayAlias") << " in the batch, "
+                            << (expected == llvm::NoAlias ? "NoAlias" : "MayAlias") << " alone\n";
+    }
+}
+
+/*!
+ * Report and reset the counts of validateAliasTests
+ */
+void WPAPass::reportAliasTests(const std::string& source) {
+    SVFUtil::outs() << "[WPAPass] Checking the alias results of " << source << "\n";
+    if (numOfAliasMismatches == 0)
+        SVFUtil::outs() << SVFUtil::sucMsg("\t SUCCESS :") << numOfCheckedAliases << " pair results are the ones given pair by pair\n";
+    else
+        SVFUtil::errs() << SVFUtil::errMsg("\t FAIL :") << numOfAliasMismatches << " of " << numOfCheckedAliases
+                        << " pair results differ from the ones given pair by pair\n";
+    numOfCheckedAliases = 0;
+    numOfAliasMismatches = 0;
 }